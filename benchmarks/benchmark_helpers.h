@@ -0,0 +1,98 @@
+#ifndef BioCroWP_BENCHMARK_HELPERS_H
+#define BioCroWP_BENCHMARK_HELPERS_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "framework/module.h"
+#include "framework/module_creator.h"
+#include "framework/module_factory.h"
+#include "framework/state_map.h"
+#include "module_library/module_library.h"
+
+using library = BioCroWP::module_library;
+
+/**
+ *  @brief Returns the average time of `reps` calls to `f`, in ns.
+ */
+template <typename F>
+double time_ns(long reps, F&& f)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (long i = 0; i < reps; ++i) {
+        f(i);
+    }
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - start)
+               .count() /
+           reps;
+}
+
+/**
+ *  @brief Creates the named module, bound to the given quantity maps.
+ */
+inline std::unique_ptr<module> create_module(
+    std::string const& module_name,
+    state_map const& input_quantities,
+    state_map* output_quantities)
+{
+    std::unique_ptr<module_creator> w{module_factory<library>::retrieve(module_name)};
+    return w->create_module(input_quantities, output_quantities);
+}
+
+/**
+ *  @brief Adds a zero entry to `quantities` for each output of the named
+ *  module.
+ */
+inline void add_module_outputs(std::string const& module_name, state_map& quantities)
+{
+    std::unique_ptr<module_creator> w{module_factory<library>::retrieve(module_name)};
+    for (std::string const& name : w->get_outputs()) {
+        quantities[name] = 0.0;
+    }
+}
+
+/**
+ *  @brief The six-layer soil and plant inputs used by the tests of the
+ *  hydraulic modules.
+ */
+inline state_map hydraulic_inputs()
+{
+    double const soil_n[] = {1.5, 1.4, 1.3, 1.45, 1.35, 1.25};
+    double const soil_alpha[] = {0.03, 0.02, 0.025, 0.015, 0.01, 0.012};
+    double const soil_depth[] = {5, 10, 20, 20, 20, 25};
+    double const soil_water_content[] = {0.3, 0.28, 0.31, 0.33, 0.35, 0.36};
+
+    state_map inputs{
+        {"max_rooting_layer", 4},
+        {"leaf_temperature", 298.15},
+        {"soil_temperature_avg", 293.15},
+        {"root_volume", 1e-6},
+        {"stem_volume", 7.869e-7},
+        {"leaf_volume", 2.852e-5},
+        {"storage_water_frac", 0.8},
+        {"root_pressure_potential", -0.05},
+        {"stem_pressure_potential", -0.4},
+        {"leaf_pressure_potential", -0.6},
+        {"minimum_temp_day", 20.9},
+        {"maximum_temp_day", 32.3},
+        {"hour", 13}};
+
+    for (int l = 0; l < 6; ++l) {
+        std::string const layer = "_" + std::to_string(l + 1);
+        inputs["soil_n" + layer] = soil_n[l];
+        inputs["soil_m" + layer] = 1 - 1 / soil_n[l];
+        inputs["soil_alpha" + layer] = soil_alpha[l];
+        inputs["soil_residual_wc" + layer] = 0.05;
+        inputs["soil_saturated_wc" + layer] = 0.45;
+        inputs["soil_depth" + layer] = soil_depth[l];
+        inputs["soil_water_content" + layer] = soil_water_content[l];
+        inputs["soil_saturation_capacity" + layer] = 0.45;
+        inputs["soil_clay_content" + layer] = 20;
+        inputs["soil_type_indicator" + layer] = 3;
+    }
+
+    return inputs;
+}
+
+#endif
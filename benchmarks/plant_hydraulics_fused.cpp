@@ -0,0 +1,78 @@
+// Compares plant_hydraulics_fused with the chain of modules it replaces
+// (soil_potential, osmotic_potential, and total_potential), both bound to a
+// shared quantity map as they would be in a dynamical_system. The outputs are
+// checked for bitwise equality, and then each version is timed.
+//
+// See README.md in this directory for build instructions.
+
+#include <algorithm>  // for std::min
+#include <cstring>    // for std::memcmp
+#include <iostream>
+#include <string>
+#include "benchmark_helpers.h"
+
+int main()
+{
+    string_vector const chain_modules = {"soil_potential", "osmotic_potential", "total_potential"};
+
+    state_map chain_quantities = hydraulic_inputs();
+    for (std::string const& name : chain_modules) {
+        add_module_outputs(name, chain_quantities);
+    }
+    state_map fused_quantities = chain_quantities;
+
+    module_vector chain;
+    for (std::string const& name : chain_modules) {
+        chain.push_back(create_module(name, chain_quantities, &chain_quantities));
+    }
+    auto fused = create_module("plant_hydraulics_fused", fused_quantities, &fused_quantities);
+
+    // Check that the outputs are identical
+    int mismatches = 0;
+    for (int rooting_layers = 1; rooting_layers <= 6; ++rooting_layers) {
+        chain_quantities.at("max_rooting_layer") = rooting_layers;
+        fused_quantities.at("max_rooting_layer") = rooting_layers;
+
+        run_module_list(chain);
+        fused->run();
+
+        for (auto const& x : chain_quantities) {
+            if (std::memcmp(&x.second, &fused_quantities.at(x.first), sizeof(double)) != 0) {
+                std::cout << "mismatch for " << x.first << " with "
+                          << rooting_layers << " rooting layers\n";
+                ++mismatches;
+            }
+        }
+    }
+    std::cout << "mismatched outputs: " << mismatches << "\n";
+
+    // Time both versions while the top layer water content changes, so no
+    // evaluation can be skipped
+    long const reps = 1000000;
+    double& chain_water_content = chain_quantities.at("soil_water_content_1");
+    double& fused_water_content = fused_quantities.at("soil_water_content_1");
+
+    // Alternate between the versions and keep the fastest of several rounds to
+    // reduce the influence of other activity on the machine
+    double chain_ns = 0.0;
+    double fused_ns = 0.0;
+    for (int round = 0; round < 5; ++round) {
+        double const c = time_ns(reps, [&](long i) {
+            chain_water_content = 0.3 + 1e-6 * (i % 1000);
+            run_module_list(chain);
+        });
+
+        double const f = time_ns(reps, [&](long i) {
+            fused_water_content = 0.3 + 1e-6 * (i % 1000);
+            fused->run();
+        });
+
+        chain_ns = round == 0 ? c : std::min(chain_ns, c);
+        fused_ns = round == 0 ? f : std::min(fused_ns, f);
+    }
+
+    std::cout << "modular chain:          " << chain_ns << " ns per evaluation\n"
+              << "plant_hydraulics_fused: " << fused_ns << " ns per evaluation\n";
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// Times richards_soil_water for increasing numbers of layers in a 200 cm loam
+// profile, with one-hour calls as they would be made by the Euler solver:
+//
+// - drainage of a uniform profile under a unit gradient, which takes one
+//   implicit step per call
+//
+// - 0.5 cm / hr of infiltration into a dry profile, where the wetting front
+//   requires many shorter steps
+//
+// - 20 cm / hr onto a wet profile, where the surface ponds and most of the
+//   water runs off
+//
+// The water balance of the first hour of each case is checked: the change in
+// storage plus the runoff and the drainage from the bottom layer, which the
+// wetting front does not reach, must equal the surface flux.
+//
+// See README.md in this directory for build instructions.
+
+#include <algorithm>  // for std::max, std::min
+#include <cmath>      // for std::abs, std::pow, std::sqrt
+#include <iostream>
+#include <string>
+#include <vector>
+#include "framework/module_helper_functions.h"  // for generate_multilayer_quantity_names
+#include "benchmark_helpers.h"
+#include "module_library/richards_soil_water.h"
+
+namespace
+{
+// A uniform loam with the van Genuchten parameters of Carsel and Parrish (1988)
+double const soil_n = 1.56;
+double const soil_m = 1 - 1 / soil_n;
+double const soil_alpha = 0.036;                  // cm-1
+double const soil_residual_wc = 0.078;            // dimensionless
+double const soil_saturated_wc = 0.43;            // dimensionless
+double const soil_saturated_conductivity = 1.04;  // cm / hr
+double const profile_depth = 200;                 // cm
+
+// Mualem - van Genuchten conductivity (cm / hr)
+double conductivity(double water_content)
+{
+    double const Se = (water_content - soil_residual_wc) / (soil_saturated_wc - soil_residual_wc);
+    double const s = 1 - std::pow(1 - std::pow(Se, 1 / soil_m), soil_m);
+    return soil_saturated_conductivity * std::sqrt(Se) * s * s;
+}
+
+void set_layers(state_map& quantities, int nlayers, std::string const& name, double value)
+{
+    for (std::string const& layer : generate_multilayer_quantity_names(nlayers, {name})) {
+        quantities[layer] = value;
+    }
+}
+
+struct benchmark_case {
+    std::string label;
+    double water_content;  // dimensionless
+    double surface_flux;   // cm / hr
+};
+
+// Returns the water balance error of the first hour, in cm, and sets `us` to
+// the average time per simulated hour over a day of one-hour calls
+double run_case(int nlayers, benchmark_case const& c, double& us)
+{
+    double const depth = profile_depth / nlayers;
+
+    state_map inputs{{"timestep", 1.0}, {"soil_surface_flux", c.surface_flux}};
+    set_layers(inputs, nlayers, "soil_water_content", c.water_content);
+    set_layers(inputs, nlayers, "soil_depth", depth);
+    set_layers(inputs, nlayers, "soil_alpha", soil_alpha);
+    set_layers(inputs, nlayers, "soil_n", soil_n);
+    set_layers(inputs, nlayers, "soil_m", soil_m);
+    set_layers(inputs, nlayers, "soil_residual_wc", soil_residual_wc);
+    set_layers(inputs, nlayers, "soil_saturated_wc", soil_saturated_wc);
+    set_layers(inputs, nlayers, "soil_saturated_conductivity", soil_saturated_conductivity);
+
+    string_vector const water_content_names =
+        generate_multilayer_quantity_names(nlayers, {"soil_water_content"});
+
+    state_map outputs;
+    for (std::string const& name : BioCroWP::richards_soil_water::get_outputs(nlayers)) {
+        outputs[name] = 0.0;
+    }
+
+    // Check the water balance of the first hour
+    double balance_error;
+    {
+        BioCroWP::richards_soil_water module(nlayers, inputs, &outputs);
+        module.run();
+
+        double storage = 0.0;
+        for (std::string const& name : water_content_names) {
+            storage += outputs.at(name) * depth;
+        }
+
+        balance_error = storage + outputs.at("soil_surface_runoff") +
+                        conductivity(c.water_content) - c.surface_flux;
+    }
+
+    // Time a day of one-hour calls, starting from the initial profile each
+    // time; the module is only created once, as in a dynamical_system
+    BioCroWP::richards_soil_water module(nlayers, inputs, &outputs);
+    int const hours = 24;
+    long const reps = std::max(1, 2000 / nlayers);
+
+    us = time_ns(reps, [&](long) {
+             for (std::string const& name : water_content_names) {
+                 inputs.at(name) = c.water_content;
+             }
+             for (int hour = 0; hour < hours; ++hour) {
+                 for (auto& x : outputs) {
+                     x.second = 0.0;
+                 }
+                 module.run();
+                 for (std::string const& name : water_content_names) {
+                     inputs.at(name) += outputs.at(name);
+                 }
+             }
+         }) /
+         hours / 1000;
+
+    return balance_error;
+}
+}  // namespace
+
+int main()
+{
+    std::vector<benchmark_case> const cases = {
+        {"drainage", 0.3, conductivity(0.3)},
+        {"0.5 cm/hr into dry soil", 0.15, 0.5},
+        {"20 cm/hr onto wet soil", 0.3, 20.0}};
+
+    double worst_error = 0.0;
+    for (benchmark_case const& c : cases) {
+        std::cout << c.label << ":\n";
+        for (int nlayers : {50, 100, 200, 400, 800}) {
+            double us;
+            double const error = run_case(nlayers, c, us);
+            worst_error = std::max(worst_error, std::abs(error));
+
+            std::cout << "  " << nlayers << " layers: " << us
+                      << " us per simulated hour, first-hour water balance error "
+                      << error << " cm\n";
+        }
+    }
+
+    std::cout << "largest water balance error: " << worst_error << " cm\n";
+
+    return worst_error < 1e-6 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+// Compares static_module_pipeline with the equivalent module_vector, both
+// bound to a shared quantity map as they would be in a dynamical_system:
+//
+// - hydraulic_potential_pipeline against soil_temperature, soil_potential,
+//   osmotic_potential, and total_potential
+//
+// - two trivial modules defined in this file, where the cost of dispatch is
+//   most visible
+//
+// The outputs of the first comparison are checked for bitwise equality.
+//
+// See README.md in this directory for build instructions.
+
+#include <algorithm>  // for std::min
+#include <cstring>    // for std::memcmp
+#include <iostream>
+#include <string>
+#include "framework/module_helper_functions.h"  // for get_input, get_op
+#include "benchmark_helpers.h"
+#include "module_library/static_module_pipeline.h"
+
+namespace
+{
+// Two trivial modules: C = A + B, then D = 2 * C. The header modules of this
+// library cannot be used here, because their member functions are defined in
+// their headers and are already compiled into module_library.cpp.
+class add_module : public direct_module
+{
+   public:
+    add_module(state_map const& input_quantities, state_map* output_quantities)
+        : direct_module(),
+          A{get_input(input_quantities, "A")},
+          B{get_input(input_quantities, "B")},
+          C_op{get_op(output_quantities, "C")}
+    {
+    }
+    static string_vector get_inputs() { return {"A", "B"}; }
+    static string_vector get_outputs() { return {"C"}; }
+    static std::string get_name() { return "add_module"; }
+
+   private:
+    double const& A;
+    double const& B;
+    double* C_op;
+    void do_operation() const { update(C_op, A + B); }
+
+    template <typename... Modules>
+    friend class BioCroWP::static_module_pipeline;
+};
+
+class double_module : public direct_module
+{
+   public:
+    double_module(state_map const& input_quantities, state_map* output_quantities)
+        : direct_module(),
+          C{get_input(input_quantities, "C")},
+          D_op{get_op(output_quantities, "D")}
+    {
+    }
+    static string_vector get_inputs() { return {"C"}; }
+    static string_vector get_outputs() { return {"D"}; }
+    static std::string get_name() { return "double_module"; }
+
+   private:
+    double const& C;
+    double* D_op;
+    void do_operation() const { update(D_op, 2 * C); }
+
+    template <typename... Modules>
+    friend class BioCroWP::static_module_pipeline;
+};
+
+class trivial_pipeline
+    : public BioCroWP::static_module_pipeline<add_module, double_module>
+{
+   public:
+    using static_module_pipeline::static_module_pipeline;
+    static std::string get_name() { return "trivial_pipeline"; }
+};
+
+// Times a module list and the equivalent single module, alternating between
+// them and keeping the fastest of several rounds; `vary` changes an input
+// before each evaluation
+template <typename V>
+void compare(
+    std::string const& label,
+    module_vector const& dynamic,
+    module const& pipeline,
+    long reps,
+    V&& vary)
+{
+    double dynamic_ns = 0.0;
+    double pipeline_ns = 0.0;
+    for (int round = 0; round < 5; ++round) {
+        double const d = time_ns(reps, [&](long i) {
+            vary(i);
+            run_module_list(dynamic);
+        });
+
+        double const p = time_ns(reps, [&](long i) {
+            vary(i);
+            pipeline.run();
+        });
+
+        dynamic_ns = round == 0 ? d : std::min(dynamic_ns, d);
+        pipeline_ns = round == 0 ? p : std::min(pipeline_ns, p);
+    }
+
+    std::cout << label << "\n"
+              << "  module_vector:          " << dynamic_ns << " ns per evaluation\n"
+              << "  static_module_pipeline: " << pipeline_ns << " ns per evaluation\n";
+}
+}  // namespace
+
+int main()
+{
+    // The standard hydraulic potential modules
+    string_vector const member_modules = {
+        "soil_temperature", "soil_potential", "osmotic_potential", "total_potential"};
+
+    state_map quantities = hydraulic_inputs();
+    quantities.erase("soil_temperature_avg");  // calculated by soil_temperature
+    for (std::string const& name : member_modules) {
+        add_module_outputs(name, quantities);
+    }
+    state_map pipeline_quantities = quantities;
+
+    module_vector members;
+    for (std::string const& name : member_modules) {
+        members.push_back(create_module(name, quantities, &quantities));
+    }
+    auto pipeline = create_module("hydraulic_potential_pipeline", pipeline_quantities, &pipeline_quantities);
+
+    int mismatches = 0;
+    for (int hour = 0; hour < 24; ++hour) {
+        quantities.at("hour") = hour;
+        pipeline_quantities.at("hour") = hour;
+
+        run_module_list(members);
+        pipeline->run();
+
+        for (auto const& x : quantities) {
+            if (std::memcmp(&x.second, &pipeline_quantities.at(x.first), sizeof(double)) != 0) {
+                std::cout << "mismatch for " << x.first << " at hour " << hour << "\n";
+                ++mismatches;
+            }
+        }
+    }
+    std::cout << "mismatched outputs: " << mismatches << "\n";
+
+    double& hour = quantities.at("hour");
+    double& pipeline_hour = pipeline_quantities.at("hour");
+
+    compare("hydraulic_potential_pipeline (four modules)", members, *pipeline, 500000, [&](long i) {
+        hour = i % 24;
+        pipeline_hour = i % 24;
+    });
+
+    // Two trivial modules
+    state_map trivial_quantities{{"A", 1.0}, {"B", 2.0}, {"C", 0.0}, {"D", 0.0}};
+
+    module_vector trivial_members;
+    trivial_members.emplace_back(new add_module(trivial_quantities, &trivial_quantities));
+    trivial_members.emplace_back(new double_module(trivial_quantities, &trivial_quantities));
+    trivial_pipeline trivial(trivial_quantities, &trivial_quantities);
+
+    double& A = trivial_quantities.at("A");
+    compare("two trivial modules", trivial_members, trivial, 20000000, [&](long i) {
+        A = static_cast<double>(i);
+    });
+
+    return mismatches == 0 ? 0 : 1;
+}
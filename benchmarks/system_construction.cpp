@@ -0,0 +1,144 @@
+// Times the construction of dynamical systems made from this library's
+// layered soil modules, together with the time needed to retrieve their module
+// creators and list the inputs and outputs once.
+//
+// See README.md in this directory for build instructions.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>  // for std::pair
+#include <vector>
+#include "framework/dynamical_system.h"
+#include "framework/module_factory.h"
+#include "module_library/module_library.h"
+
+using library = BioCroWP::module_library;
+
+namespace
+{
+struct system_definition {
+    std::string label;
+    string_vector direct_modules;
+    string_vector differential_modules;
+};
+
+double elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Retrieves a creator for each module; the creators are owned by `owner`
+mc_vector retrieve_all(
+    string_vector const& module_names,
+    std::vector<std::unique_ptr<module_creator>>& owner)
+{
+    mc_vector mcs;
+    for (std::string const& name : module_names) {
+        owner.emplace_back(module_factory<library>::retrieve(name));
+        mcs.push_back(owner.back().get());
+    }
+    return mcs;
+}
+
+// Retrieves each creator and lists its quantities once
+size_t list_quantities(string_vector const& module_names)
+{
+    size_t n = 0;
+    for (std::string const& name : module_names) {
+        std::unique_ptr<module_creator> w{module_factory<library>::retrieve(name)};
+        n += w->get_inputs().size() + w->get_outputs().size();
+    }
+    return n;
+}
+
+void run_case(system_definition const& def, int reps)
+{
+    std::vector<std::unique_ptr<module_creator>> owner;
+    mc_vector const direct = retrieve_all(def.direct_modules, owner);
+    mc_vector const differential = retrieve_all(def.differential_modules, owner);
+
+    // The differential quantities are the outputs of the differential
+    // modules; every other module input that is not calculated by a direct
+    // module is a parameter
+    state_map initial_values;
+    for (module_creator* w : differential) {
+        for (std::string const& name : w->get_outputs()) {
+            initial_values[name] = 0.3;
+        }
+    }
+
+    string_set direct_outputs;
+    for (module_creator* w : direct) {
+        for (std::string const& name : w->get_outputs()) {
+            direct_outputs.insert(name);
+        }
+    }
+
+    state_map parameters{{"timestep", 1.0}};
+    for (auto const& w : owner) {
+        for (std::string const& name : w->get_inputs()) {
+            if (name != "time" && initial_values.count(name) == 0 &&
+                direct_outputs.count(name) == 0) {
+                parameters[name] = 0.3;
+            }
+        }
+    }
+
+    state_vector_map const drivers{{"time", {0.0, 1.0}}};
+
+    auto start = std::chrono::steady_clock::now();
+    size_t nquantities = 0;
+    for (int i = 0; i < reps; ++i) {
+        dynamical_system sys{initial_values, parameters, drivers, direct, differential};
+        nquantities = sys.get_differential_quantity_names().size();
+    }
+    double const construction = elapsed_us(start) / reps;
+
+    string_vector all_names = def.direct_modules;
+    all_names.insert(
+        all_names.end(), def.differential_modules.begin(), def.differential_modules.end());
+
+    start = std::chrono::steady_clock::now();
+    size_t nlisted = 0;
+    for (int i = 0; i < reps; ++i) {
+        nlisted = list_quantities(all_names);
+    }
+    double const listing = elapsed_us(start) / reps;
+
+    std::cout << def.label << ": " << all_names.size() << " modules, "
+              << nlisted << " module quantities, "
+              << nquantities << " differential quantities\n"
+              << "  system construction:        " << construction << " us\n"
+              << "  one retrieve-and-list pass: " << listing << " us\n";
+}
+}  // namespace
+
+int main()
+{
+    string_vector const plant_direct = {"soil_potential", "osmotic_potential", "total_potential"};
+
+    std::vector<std::pair<int, std::string>> const sizes = {
+        {50, "fifty"}, {100, "hundred"}, {200, "two_hundred"}};
+
+    std::vector<system_definition> definitions;
+    for (auto const& size : sizes) {
+        system_definition def{
+            std::to_string(size.first) + " soil layers with plant hydraulics",
+            plant_direct,
+            {"pressure_potential"}};
+
+        def.direct_modules.push_back(size.second + "_layer_soil_potential");
+        def.differential_modules.push_back(size.second + "_layer_richards_soil_water");
+        def.differential_modules.push_back(size.second + "_layer_soil_temperature");
+
+        definitions.push_back(def);
+    }
+
+    for (system_definition const& def : definitions) {
+        run_case(def, 10);
+    }
+}
@@ -0,0 +1,209 @@
+#include <cstdint>    // for uint64_t
+#include <exception>  // for std::exception
+#include <stdexcept>  // for std::invalid_argument
+#include <string>
+#include <vector>
+#include <Rinternals.h>                    // for Rf_error
+#include "framework/state_map.h"           // for state_map, state_vector_map, string_vector
+#include "framework/R_helper_functions.h"  // for map_from_list, map_vector_from_list, make_vector, mc_vector_from_list, r_string_vector_from_vector
+#include "framework/module_creator.h"      // for mc_vector
+#include "ensemble.h"
+#include "R_ensemble.h"
+
+using std::string;
+using BioCroWP::ensemble_statistics;
+using BioCroWP::parameter_distribution;
+
+namespace
+{
+/**
+ *  @brief Makes a named list of numeric columns, one for each quantity in
+ *  `statistics`, where `value(t, q)` gives the element for time point `t` of
+ *  quantity `q`.
+ */
+template <typename F>
+SEXP statistic_table(ensemble_statistics const& statistics, F&& value)
+{
+    string_vector const& quantities = statistics.get_quantities();
+    size_t const ntimes = statistics.get_ntimes();
+
+    SEXP table = PROTECT(Rf_allocVector(VECSXP, quantities.size()));
+    for (size_t q = 0; q < quantities.size(); ++q) {
+        SET_VECTOR_ELT(table, q, Rf_allocVector(REALSXP, ntimes));
+        double* column = REAL(VECTOR_ELT(table, q));
+        for (size_t t = 0; t < ntimes; ++t) {
+            column[t] = value(t, q);
+        }
+    }
+    Rf_setAttrib(table, R_NamesSymbol, r_string_vector_from_vector(quantities));
+
+    UNPROTECT(1);  // UNPROTECT table
+    return table;
+}
+
+parameter_distribution::shape distribution_shape(string const& name)
+{
+    if (name == "uniform") {
+        return parameter_distribution::shape::uniform;
+    }
+    if (name == "normal") {
+        return parameter_distribution::shape::normal;
+    }
+    if (name == "log_normal") {
+        return parameter_distribution::shape::log_normal;
+    }
+    throw std::invalid_argument(string("'") + name + "' is not a supported distribution");
+}
+}  // namespace
+
+extern "C" {
+
+/**
+ *  @brief Runs an ensemble of simulations whose parameters are drawn from
+ *  the given distributions, and returns per-time-point statistics of the
+ *  results
+ *
+ *  The first ten arguments are the same as the arguments of BioCro's
+ *  `R_run_biocro`, except that the modules are given as lists of module
+ *  creators rather than names.
+ *
+ *  @param [in] distributions A list of four vectors with one element per
+ *              sampled quantity: the names, the distribution names
+ *              (`uniform`, `normal`, or `log_normal`), and the first and
+ *              second distribution parameters
+ *
+ *  @param [in] members The number of ensemble members
+ *
+ *  @param [in] design Either `random` or `latin_hypercube`
+ *
+ *  @param [in] seed The seed from which each member's random number
+ *              generator is seeded; a non-negative whole number
+ *
+ *  @param [in] quantities The names of the quantities to summarize; if this
+ *              is empty, every quantity is summarized
+ *
+ *  @param [in] probabilities The probabilities of the quantiles to estimate
+ *
+ *  @param [in] compression The t-digest compression
+ *
+ *  @param [in] nthreads The maximum number of members to simulate at once
+ *
+ *  @return A named list with the sampled values (`parameters`), the
+ *          statistics (`mean`, `variance`, `minimum`, and `maximum`), and a
+ *          list with one element per probability (`quantiles`); each of
+ *          these is a named list of numeric vectors
+ */
+SEXP R_run_ensemble(
+    SEXP initial_values,
+    SEXP parameters,
+    SEXP drivers,
+    SEXP direct_module_creators,
+    SEXP differential_module_creators,
+    SEXP solver_type,
+    SEXP solver_output_step_size,
+    SEXP solver_adaptive_rel_error_tol,
+    SEXP solver_adaptive_abs_error_tol,
+    SEXP solver_adaptive_max_steps,
+    SEXP distributions,
+    SEXP members,
+    SEXP design,
+    SEXP seed,
+    SEXP quantities,
+    SEXP probabilities,
+    SEXP compression,
+    SEXP nthreads)
+{
+    try {
+        state_map const s = map_from_list(initial_values);
+        state_map const ip = map_from_list(parameters);
+        state_vector_map const vp = map_vector_from_list(drivers);
+
+        mc_vector const direct_mcs = mc_vector_from_list(direct_module_creators);
+        mc_vector const differential_mcs = mc_vector_from_list(differential_module_creators);
+
+        string const solver_type_string = make_vector(solver_type)[0];
+        double const output_step_size = REAL(solver_output_step_size)[0];
+        double const adaptive_rel_error_tol = REAL(solver_adaptive_rel_error_tol)[0];
+        double const adaptive_abs_error_tol = REAL(solver_adaptive_abs_error_tol)[0];
+        int const adaptive_max_steps = (int)REAL(solver_adaptive_max_steps)[0];
+
+        // Describe the distributions
+        string_vector const names = make_vector(VECTOR_ELT(distributions, 0));
+        string_vector const shapes = make_vector(VECTOR_ELT(distributions, 1));
+        double const* a = REAL(VECTOR_ELT(distributions, 2));
+        double const* b = REAL(VECTOR_ELT(distributions, 3));
+
+        std::vector<parameter_distribution> sampled;
+        for (size_t j = 0; j < names.size(); ++j) {
+            sampled.push_back({names[j], distribution_shape(shapes[j]), a[j], b[j]});
+        }
+
+        string const design_string = make_vector(design)[0];
+        BioCroWP::sampling_design const sampling_design =
+            design_string == "latin_hypercube" ? BioCroWP::sampling_design::latin_hypercube
+                                               : BioCroWP::sampling_design::random;
+
+        std::vector<std::vector<double>> const samples = BioCroWP::sample_parameters(
+            sampled,
+            static_cast<size_t>(Rf_asInteger(members)),
+            sampling_design,
+            static_cast<uint64_t>(REAL(seed)[0]));
+
+        // Run the members; no R API functions are called until they finish
+        ensemble_statistics const statistics = BioCroWP::run_ensemble(
+            s, ip, vp, direct_mcs, differential_mcs,
+            solver_type_string, output_step_size, adaptive_rel_error_tol,
+            adaptive_abs_error_tol, adaptive_max_steps,
+            names, samples, make_vector(quantities),
+            REAL(compression)[0], Rf_asInteger(nthreads));
+
+        // Collect the sampled values and the statistics
+        SEXP sampled_values = PROTECT(Rf_allocVector(VECSXP, names.size()));
+        for (size_t j = 0; j < names.size(); ++j) {
+            SET_VECTOR_ELT(sampled_values, j, Rf_allocVector(REALSXP, samples.size()));
+            double* column = REAL(VECTOR_ELT(sampled_values, j));
+            for (size_t i = 0; i < samples.size(); ++i) {
+                column[i] = samples[i][j];
+            }
+        }
+        Rf_setAttrib(sampled_values, R_NamesSymbol, r_string_vector_from_vector(names));
+
+        SEXP quantile_tables = PROTECT(Rf_allocVector(VECSXP, Rf_xlength(probabilities)));
+        for (R_xlen_t k = 0; k < Rf_xlength(probabilities); ++k) {
+            double const p = REAL(probabilities)[k];
+            SET_VECTOR_ELT(quantile_tables, k, statistic_table(statistics, [&](size_t t, size_t q) {
+                               return statistics.quantile(t, q, p);
+                           }));
+        }
+
+        SEXP result = PROTECT(Rf_allocVector(VECSXP, 6));
+        SET_VECTOR_ELT(result, 0, sampled_values);
+        SET_VECTOR_ELT(result, 1, statistic_table(statistics, [&](size_t t, size_t q) {
+                           return statistics.mean(t, q);
+                       }));
+        SET_VECTOR_ELT(result, 2, statistic_table(statistics, [&](size_t t, size_t q) {
+                           return statistics.variance(t, q);
+                       }));
+        SET_VECTOR_ELT(result, 3, statistic_table(statistics, [&](size_t t, size_t q) {
+                           return statistics.minimum(t, q);
+                       }));
+        SET_VECTOR_ELT(result, 4, statistic_table(statistics, [&](size_t t, size_t q) {
+                           return statistics.maximum(t, q);
+                       }));
+        SET_VECTOR_ELT(result, 5, quantile_tables);
+        Rf_setAttrib(
+            result,
+            R_NamesSymbol,
+            r_string_vector_from_vector(
+                {"parameters", "mean", "variance", "minimum", "maximum", "quantiles"}));
+
+        UNPROTECT(3);  // UNPROTECT sampled_values, quantile_tables, result
+        return result;
+
+    } catch (std::exception const& e) {
+        Rf_error((string("Caught exception in R_run_ensemble: ") + e.what()).c_str());
+    } catch (...) {
+        Rf_error("Caught unhandled exception in R_run_ensemble.");
+    }
+}
+}
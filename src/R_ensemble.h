@@ -0,0 +1,26 @@
+#ifndef R_ENSEMBLE_H
+#define R_ENSEMBLE_H
+
+#include <Rinternals.h>  // for SEXP
+
+extern "C" SEXP R_run_ensemble(
+    SEXP initial_values,
+    SEXP parameters,
+    SEXP drivers,
+    SEXP direct_module_creators,
+    SEXP differential_module_creators,
+    SEXP solver_type,
+    SEXP solver_output_step_size,
+    SEXP solver_adaptive_rel_error_tol,
+    SEXP solver_adaptive_abs_error_tol,
+    SEXP solver_adaptive_max_steps,
+    SEXP distributions,
+    SEXP members,
+    SEXP design,
+    SEXP seed,
+    SEXP quantities,
+    SEXP probabilities,
+    SEXP compression,
+    SEXP nthreads);
+
+#endif
@@ -0,0 +1,225 @@
+#include <algorithm>      // for std::min
+#include <exception>      // for std::exception, std::exception_ptr
+#include <memory>         // for std::unique_ptr
+#include <stdexcept>      // for std::invalid_argument
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <Rinternals.h>                    // for Rf_error
+#include "framework/state_map.h"           // for string_vector, state_map_from_names
+#include "framework/R_helper_functions.h"  // for make_vector, r_string_vector_from_vector
+#include "framework/module_creator.h"      // for module_creator
+#include "framework/module_factory.h"
+#include "module_library/module_library.h"
+#include "R_module_batch.h"
+
+using std::string;
+using library = BioCroWP::module_library;
+
+namespace
+{
+// Threads are only worthwhile when each one has a reasonable number of rows
+size_t const min_rows_per_thread = 1000;
+
+/**
+ *  @brief One input column; a column of length 1 supplies the same value to
+ *  every row.
+ */
+struct input_column {
+    const double* values;
+    bool recycled;
+};
+
+/**
+ *  @brief Evaluates a module for rows `begin` through `end - 1` of a columnar
+ *  table.
+ *
+ *  A single module object is created and bound to a pair of `state_map`
+ *  objects; for each row, the input values are copied into the bound input
+ *  slots, the module is run, and its outputs are copied into the output
+ *  columns. No R API functions are called here, so this function can safely
+ *  run on a worker thread.
+ */
+void evaluate_rows(
+    string const& module_name,
+    string_vector const& input_names,
+    std::vector<input_column> const& inputs,
+    string_vector const& output_names,
+    std::vector<double*> const& outputs,
+    size_t begin,
+    size_t end)
+{
+    std::unique_ptr<module_creator> w{module_factory<library>::retrieve(module_name)};
+
+    state_map input_quantities = state_map_from_names(input_names);
+    state_map output_quantities = state_map_from_names(output_names);
+    std::unique_ptr<module> m = w->create_module(input_quantities, &output_quantities);
+
+    std::vector<double*> input_slots;
+    for (string const& name : input_names) {
+        input_slots.push_back(&input_quantities.at(name));
+    }
+
+    std::vector<double*> output_slots;
+    for (string const& name : output_names) {
+        output_slots.push_back(&output_quantities.at(name));
+    }
+
+    for (size_t row = begin; row < end; ++row) {
+        for (size_t i = 0; i < input_slots.size(); ++i) {
+            *input_slots[i] = inputs[i].values[inputs[i].recycled ? 0 : row];
+        }
+
+        // Differential modules add to their outputs rather than overwriting
+        // them, so the outputs must start from zero for each row
+        for (double* slot : output_slots) {
+            *slot = 0.0;
+        }
+
+        m->run();
+
+        for (size_t j = 0; j < output_slots.size(); ++j) {
+            outputs[j][row] = *output_slots[j];
+        }
+    }
+}
+}  // namespace
+
+extern "C" {
+
+/**
+ *  @brief Evaluates a single module over every row of a columnar input table
+ *
+ *  This is much faster than evaluating the module one row at a time from R
+ *  because the module is only created once per thread and its inputs and
+ *  outputs are exchanged through pointers to the R vectors.
+ *
+ *  The rows can optionally be divided among several threads, each of which
+ *  creates its own module object. All R objects are allocated and accessed
+ *  on the calling thread before the workers start.
+ *
+ *  @param [in] module_name The name of a module in this library, without the
+ *              library prefix
+ *
+ *  @param [in] input_table A named list of vectors; it must contain all of the
+ *              module's inputs as numeric vectors, and each of those vectors
+ *              must either have the same length as the others or a length of
+ *              1. Other elements are ignored and may have any type. The table
+ *              may have zero rows.
+ *
+ *  @param [in] nthreads The maximum number of threads to use
+ *
+ *  @return A named list of numeric vectors, one for each module output, with
+ *          one element for each row of the input table
+ */
+SEXP R_evaluate_module_batch(SEXP module_name, SEXP input_table, SEXP nthreads)
+{
+    try {
+        string const name = make_vector(module_name)[0];
+        int const requested_threads = Rf_asInteger(nthreads);
+
+        std::unique_ptr<module_creator> w{module_factory<library>::retrieve(name)};
+        string_vector const input_names = w->get_inputs();
+        string_vector const output_names = w->get_outputs();
+
+        // Index the table by column name
+        std::unordered_map<string, SEXP> columns;
+        SEXP table_names = Rf_getAttrib(input_table, R_NamesSymbol);
+        for (R_xlen_t i = 0; i < Rf_xlength(input_table); ++i) {
+            columns[CHAR(STRING_ELT(table_names, i))] = VECTOR_ELT(input_table, i);
+        }
+
+        // Find the module's input columns and the number of rows, which is
+        // the length of the first input column that is not recycled
+        string missing;
+        size_t nrows = 1;
+        bool nrows_found = false;
+        for (string const& input_name : input_names) {
+            auto const it = columns.find(input_name);
+            if (it == columns.end()) {
+                missing += (missing.empty() ? "" : ", ") + input_name;
+            } else if (TYPEOF(it->second) != REALSXP) {
+                throw std::invalid_argument(
+                    string("the '") + input_name + "' column is not numeric");
+            } else if (!nrows_found && Rf_xlength(it->second) != 1) {
+                nrows = Rf_xlength(it->second);
+                nrows_found = true;
+            }
+        }
+
+        if (!missing.empty()) {
+            throw std::invalid_argument(
+                string("the input table is missing the following inputs of the '") +
+                name + "' module: " + missing);
+        }
+
+        std::vector<input_column> inputs;
+        for (string const& input_name : input_names) {
+            SEXP column = columns.at(input_name);
+            size_t const length = Rf_xlength(column);
+            if (length != 1 && length != nrows) {
+                throw std::invalid_argument(
+                    string("the '") + input_name + "' column has " +
+                    std::to_string(length) + " elements, but all columns must have " +
+                    std::to_string(nrows) + " elements or exactly 1 element");
+            }
+            inputs.push_back({REAL(column), length == 1});
+        }
+
+        // Allocate the output table
+        SEXP result = PROTECT(Rf_allocVector(VECSXP, output_names.size()));
+        std::vector<double*> outputs;
+        for (size_t j = 0; j < output_names.size(); ++j) {
+            SET_VECTOR_ELT(result, j, Rf_allocVector(REALSXP, nrows));
+            outputs.push_back(REAL(VECTOR_ELT(result, j)));
+        }
+        Rf_setAttrib(result, R_NamesSymbol, r_string_vector_from_vector(output_names));
+
+        // Divide the rows into contiguous blocks, one for each thread
+        size_t const max_threads = std::max(nrows / min_rows_per_thread, size_t(1));
+        size_t const nblocks = std::min(
+            static_cast<size_t>(std::max(requested_threads, 1)), max_threads);
+        size_t const block_size = (nrows + nblocks - 1) / nblocks;
+
+        if (nrows == 0) {
+            // An empty table gives empty output columns, and the module is
+            // never created
+        } else if (nblocks == 1) {
+            evaluate_rows(name, input_names, inputs, output_names, outputs, 0, nrows);
+        } else {
+            std::vector<std::thread> workers;
+            std::vector<std::exception_ptr> errors(nblocks);
+            for (size_t b = 0; b < nblocks; ++b) {
+                size_t const begin = b * block_size;
+                size_t const end = std::min(begin + block_size, nrows);
+                workers.emplace_back([&, b, begin, end]() {
+                    try {
+                        evaluate_rows(name, input_names, inputs, output_names, outputs, begin, end);
+                    } catch (...) {
+                        errors[b] = std::current_exception();
+                    }
+                });
+            }
+
+            for (std::thread& t : workers) {
+                t.join();
+            }
+
+            for (std::exception_ptr const& e : errors) {
+                if (e) {
+                    std::rethrow_exception(e);
+                }
+            }
+        }
+
+        UNPROTECT(1);  // UNPROTECT result
+        return result;
+
+    } catch (std::exception const& e) {
+        Rf_error((string("Caught exception in R_evaluate_module_batch: ") + e.what()).c_str());
+    } catch (...) {
+        Rf_error("Caught unhandled exception in R_evaluate_module_batch.");
+    }
+}
+}
@@ -0,0 +1,8 @@
+#ifndef R_MODULE_BATCH_H
+#define R_MODULE_BATCH_H
+
+#include <Rinternals.h>  // for SEXP
+
+extern "C" SEXP R_evaluate_module_batch(SEXP module_name, SEXP input_table, SEXP nthreads);
+
+#endif
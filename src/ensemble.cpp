@@ -0,0 +1,485 @@
+#include <algorithm>           // for std::sort, std::min, std::max
+#include <cmath>               // for std::sqrt, std::log, std::exp, std::erfc, std::asin, std::sin, std::isnan
+#include <condition_variable>
+#include <exception>           // for std::exception, std::exception_ptr
+#include <limits>              // for std::numeric_limits
+#include <mutex>
+#include <random>              // for std::mt19937_64
+#include <stdexcept>           // for std::invalid_argument, std::runtime_error
+#include <thread>
+#include "framework/biocro_simulation.h"
+#include "ensemble.h"
+
+using std::string;
+
+namespace
+{
+double const pi = 3.14159265358979323846;
+double const not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ *  @brief The finalizer of the SplitMix64 generator, used to turn a seed and a
+ *  member index into well-separated seeds for the member generators.
+ */
+uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+/**
+ *  @brief Returns a uniform random number in the open interval (0, 1).
+ *
+ *  `std::uniform_real_distribution` is not used because its algorithm is
+ *  implementation-defined.
+ */
+double unit_uniform(std::mt19937_64& generator)
+{
+    return ((generator() >> 11) + 0.5) / 9007199254740992.0;  // 2^53
+}
+
+/**
+ *  @brief Returns a uniform random integer in [0, n), rejecting the values
+ *  that would make some integers more likely than others.
+ */
+uint64_t uniform_index(std::mt19937_64& generator, uint64_t n)
+{
+    uint64_t const threshold = (0 - n) % n;
+    uint64_t x;
+    do {
+        x = generator();
+    } while (x < threshold);
+    return x % n;
+}
+
+/**
+ *  @brief The inverse of the standard normal cumulative distribution
+ *  function.
+ *
+ *  Acklam's rational approximation, which has a relative error below 1.2e-9,
+ *  is followed by one step of Halley's method, which reduces the error to
+ *  about machine precision.
+ */
+double standard_normal_quantile(double p)
+{
+    double const a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                        -2.759285104469687e+02, 1.383577518672690e+02,
+                        -3.066479806614716e+01, 2.506628277459239e+00};
+    double const b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                        -1.556989798598866e+02, 6.680131188771972e+01,
+                        -1.328068155288572e+01};
+    double const c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                        -2.400758277161838e+00, -2.549732539343734e+00,
+                        4.374664141464968e+00, 2.938163982698783e+00};
+    double const d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                        2.445134137142996e+00, 3.754408661907416e+00};
+    double const p_low = 0.02425;
+
+    double x;
+    if (p < p_low || p > 1 - p_low) {
+        double const q = std::sqrt(-2 * std::log(p < p_low ? p : 1 - p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        if (p > 1 - p_low) {
+            x = -x;
+        }
+    } else {
+        double const q = p - 0.5;
+        double const r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+    }
+
+    double const e = 0.5 * std::erfc(-x / std::sqrt(2.0)) - p;
+    double const u = e * std::sqrt(2 * pi) * std::exp(x * x / 2);
+    return x - u / (1 + x * u / 2);
+}
+}  // namespace
+
+namespace BioCroWP
+{
+double parameter_distribution::quantile(double p) const
+{
+    switch (type) {
+        case shape::uniform:
+            return a + (b - a) * p;
+        case shape::normal:
+            return a + b * standard_normal_quantile(p);
+        case shape::log_normal:
+            return std::exp(a + b * standard_normal_quantile(p));
+    }
+    return not_a_number;
+}
+
+std::vector<std::vector<double>> sample_parameters(
+    std::vector<parameter_distribution> const& distributions,
+    size_t members,
+    sampling_design design,
+    uint64_t seed)
+{
+    uint64_t const base = splitmix64(seed);
+    size_t const nparameters = distributions.size();
+
+    // For a Latin hypercube, shuffle the intervals of each parameter with
+    // the stream that precedes the stream of the first member
+    std::vector<std::vector<size_t>> intervals;
+    if (design == sampling_design::latin_hypercube) {
+        std::mt19937_64 generator{splitmix64(base - 1)};
+        for (size_t j = 0; j < nparameters; ++j) {
+            std::vector<size_t> order(members);
+            for (size_t i = 0; i < members; ++i) {
+                order[i] = i;
+            }
+            for (size_t i = members; i > 1; --i) {
+                std::swap(order[i - 1], order[uniform_index(generator, i)]);
+            }
+            intervals.push_back(order);
+        }
+    }
+
+    std::vector<std::vector<double>> samples(members, std::vector<double>(nparameters));
+    for (size_t i = 0; i < members; ++i) {
+        std::mt19937_64 generator{splitmix64(base + i)};
+        for (size_t j = 0; j < nparameters; ++j) {
+            double const u = unit_uniform(generator);
+            double const p = design == sampling_design::latin_hypercube
+                                 ? (intervals[j][i] + u) / members
+                                 : u;
+            samples[i][j] = distributions[j].quantile(p);
+        }
+    }
+
+    return samples;
+}
+
+ensemble_statistics::ensemble_statistics(string_vector const& quantities, double compression)
+    : quantities{quantities},
+      compression{compression},
+      sketch_capacity{static_cast<size_t>(2 * std::ceil(compression))}
+{
+    if (!(compression >= 10)) {
+        throw std::invalid_argument("the t-digest compression must be at least 10");
+    }
+}
+
+ensemble_statistics::cell const& ensemble_statistics::at(size_t time, size_t quantity) const
+{
+    return cells.at(quantity * ntimes + time);
+}
+
+void ensemble_statistics::add_member(state_vector_map const& result)
+{
+    if (members == 0 && quantities.empty()) {
+        for (auto const& x : result) {
+            quantities.push_back(x.first);
+        }
+        std::sort(quantities.begin(), quantities.end());
+    }
+
+    // Find every column before changing any statistics
+    std::vector<std::vector<double> const*> columns;
+    for (string const& name : quantities) {
+        auto const it = result.find(name);
+        if (it == result.end()) {
+            throw std::invalid_argument(
+                string("'") + name + "' is not a quantity in the simulation result");
+        }
+        columns.push_back(&it->second);
+    }
+
+    if (members == 0) {
+        ntimes = columns.empty() ? 0 : columns[0]->size();
+        cells.resize(ntimes * quantities.size(), cell{0.0, 0.0, 0.0, 0.0, false, {}});
+    }
+
+    for (auto const column : columns) {
+        if (column->size() != ntimes) {
+            throw std::runtime_error(
+                "a simulation result has " + std::to_string(column->size()) +
+                " time points, but the first one had " + std::to_string(ntimes));
+        }
+    }
+
+    double const n = members + 1;
+    for (size_t j = 0; j < columns.size(); ++j) {
+        for (size_t t = 0; t < ntimes; ++t) {
+            cell& c = cells[j * ntimes + t];
+            double const x = (*columns[j])[t];
+
+            if (c.has_nan) {
+                continue;
+            }
+
+            if (std::isnan(x)) {
+                c.has_nan = true;
+                std::vector<centroid>().swap(c.centroids);
+                continue;
+            }
+
+            // Welford's update
+            if (members == 0) {
+                c.mean = x;
+                c.minimum = x;
+                c.maximum = x;
+            } else {
+                double const delta = x - c.mean;
+                c.mean += delta / n;
+                c.m2 += delta * (x - c.mean);
+                c.minimum = std::min(c.minimum, x);
+                c.maximum = std::max(c.maximum, x);
+            }
+
+            // Append to the sketch, merging it when it is full and growing it
+            // no further than its capacity
+            std::vector<centroid>& sketch = c.centroids;
+            if (sketch.size() == sketch_capacity) {
+                merge(sketch);
+            }
+            if (sketch.size() == sketch.capacity()) {
+                sketch.reserve(std::min(std::max(2 * sketch.size(), size_t(8)), sketch_capacity));
+            }
+            sketch.push_back({x, 1.0});
+        }
+    }
+
+    ++members;
+}
+
+/**
+ *  @brief Sorts the centroids and merges neighbors while the merged centroid
+ *  spans at most one unit of the arcsine scale function
+ *
+ *      k(q) = compression / (2 * pi) * asin(2 * q - 1)
+ *
+ *  where `q` is the fraction of the total weight below a point.
+ */
+void ensemble_statistics::merge(std::vector<centroid>& centroids) const
+{
+    std::sort(centroids.begin(), centroids.end(), [](centroid const& x, centroid const& y) {
+        return x.mean < y.mean || (x.mean == y.mean && x.weight < y.weight);
+    });
+
+    double total = 0.0;
+    for (centroid const& x : centroids) {
+        total += x.weight;
+    }
+
+    double const scale = compression / (2 * pi);
+    auto limit = [&](double q) {
+        double const k = scale * std::asin(2 * q - 1) + 1;
+        return k >= scale * pi / 2 ? 1.0 : (std::sin(k / scale) + 1) / 2;
+    };
+
+    size_t current = 0;
+    double before = 0.0;
+    double q_limit = limit(0.0);
+    for (size_t i = 1; i < centroids.size(); ++i) {
+        centroid const& x = centroids[i];
+        centroid& merged = centroids[current];
+        if ((before + merged.weight + x.weight) / total <= q_limit) {
+            merged.weight += x.weight;
+            merged.mean += (x.mean - merged.mean) * x.weight / merged.weight;
+        } else {
+            before += merged.weight;
+            q_limit = limit(before / total);
+            centroids[++current] = x;
+        }
+    }
+    centroids.resize(current + 1);
+}
+
+double ensemble_statistics::mean(size_t time, size_t quantity) const
+{
+    cell const& c = at(time, quantity);
+    return c.has_nan ? not_a_number : c.mean;
+}
+
+double ensemble_statistics::variance(size_t time, size_t quantity) const
+{
+    cell const& c = at(time, quantity);
+    return c.has_nan || members < 2 ? not_a_number : c.m2 / (members - 1);
+}
+
+double ensemble_statistics::minimum(size_t time, size_t quantity) const
+{
+    cell const& c = at(time, quantity);
+    return c.has_nan ? not_a_number : c.minimum;
+}
+
+double ensemble_statistics::maximum(size_t time, size_t quantity) const
+{
+    cell const& c = at(time, quantity);
+    return c.has_nan ? not_a_number : c.maximum;
+}
+
+/**
+ *  Each centroid is placed at the middle of its weight, and the quantile is
+ *  interpolated linearly between neighboring centroids, or between the
+ *  outermost centroids and the minimum or maximum.
+ */
+double ensemble_statistics::quantile(size_t time, size_t quantity, double p) const
+{
+    cell const& c = at(time, quantity);
+    if (c.has_nan) {
+        return not_a_number;
+    }
+
+    std::vector<centroid> sorted = c.centroids;
+    std::sort(sorted.begin(), sorted.end(), [](centroid const& x, centroid const& y) {
+        return x.mean < y.mean;
+    });
+
+    double const index = p * members;
+    double previous_position = 0.0;
+    double previous_value = c.minimum;
+    double cumulative = 0.0;
+    for (centroid const& x : sorted) {
+        double const position = cumulative + x.weight / 2;
+        if (index <= position) {
+            return position == previous_position
+                       ? x.mean
+                       : previous_value + (x.mean - previous_value) *
+                                              (index - previous_position) /
+                                              (position - previous_position);
+        }
+        previous_position = position;
+        previous_value = x.mean;
+        cumulative += x.weight;
+    }
+
+    return cumulative == previous_position
+               ? c.maximum
+               : previous_value + (c.maximum - previous_value) *
+                                      (index - previous_position) /
+                                      (cumulative - previous_position);
+}
+
+ensemble_statistics run_ensemble(
+    state_map const& initial_values,
+    state_map const& parameters,
+    state_vector_map const& drivers,
+    mc_vector const& direct_mcs,
+    mc_vector const& differential_mcs,
+    string const& ode_solver_name,
+    double output_step_size,
+    double adaptive_rel_error_tol,
+    double adaptive_abs_error_tol,
+    int adaptive_max_steps,
+    string_vector const& sampled_names,
+    std::vector<std::vector<double>> const& samples,
+    string_vector const& quantities,
+    double compression,
+    int nthreads)
+{
+    for (string const& name : sampled_names) {
+        if (parameters.find(name) == parameters.end() &&
+            initial_values.find(name) == initial_values.end()) {
+            throw std::invalid_argument(
+                string("'") + name + "' is not a parameter or an initial value");
+        }
+    }
+
+    for (auto const& row : samples) {
+        if (row.size() != sampled_names.size()) {
+            throw std::invalid_argument(
+                "each member must have one value for each sampled quantity");
+        }
+    }
+
+    size_t const members = samples.size();
+    ensemble_statistics statistics{quantities, compression};
+
+    auto simulate = [&](size_t member) {
+        state_map member_initial_values = initial_values;
+        state_map member_parameters = parameters;
+        for (size_t j = 0; j < sampled_names.size(); ++j) {
+            auto const it = member_parameters.find(sampled_names[j]);
+            if (it != member_parameters.end()) {
+                it->second = samples[member][j];
+            } else {
+                member_initial_values.at(sampled_names[j]) = samples[member][j];
+            }
+        }
+
+        biocro_simulation simulation{
+            member_initial_values, member_parameters, drivers,
+            direct_mcs, differential_mcs,
+            ode_solver_name, output_step_size, adaptive_rel_error_tol,
+            adaptive_abs_error_tol, adaptive_max_steps};
+
+        return simulation.run_simulation();
+    };
+
+    // Members are claimed in order by the workers, and each result is added
+    // to the statistics only after the results of all earlier members
+    std::mutex mutex;
+    std::condition_variable added;
+    size_t next_member = 0;
+    size_t next_to_add = 0;
+    std::exception_ptr error;
+    size_t error_member = members;
+
+    auto work = [&]() {
+        while (true) {
+            size_t member;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (error || next_member == members) {
+                    return;
+                }
+                member = next_member++;
+            }
+
+            state_vector_map result;
+            try {
+                result = simulate(member);
+            } catch (std::exception const& e) {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (member < error_member) {
+                    error = std::make_exception_ptr(std::runtime_error(
+                        "member " + std::to_string(member + 1) + ": " + e.what()));
+                    error_member = member;
+                }
+                added.notify_all();
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock{mutex};
+            added.wait(lock, [&]() { return error || next_to_add == member; });
+            if (error) {
+                return;
+            }
+            try {
+                statistics.add_member(result);
+            } catch (...) {
+                error = std::current_exception();
+                error_member = member;
+            }
+            ++next_to_add;
+            added.notify_all();
+        }
+    };
+
+    size_t const nworkers = std::min(static_cast<size_t>(std::max(nthreads, 1)), members);
+    if (nworkers <= 1) {
+        work();
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < nworkers; ++w) {
+            workers.emplace_back(work);
+        }
+        for (std::thread& t : workers) {
+            t.join();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return statistics;
+}
+
+}  // namespace BioCroWP
@@ -0,0 +1,163 @@
+#ifndef BioCroWP_ENSEMBLE_H
+#define BioCroWP_ENSEMBLE_H
+
+#include <cstdint>  // for uint64_t
+#include <string>
+#include <vector>
+#include "framework/module_creator.h"  // for mc_vector
+#include "framework/state_map.h"       // for state_map, state_vector_map, string_vector
+
+namespace BioCroWP
+{
+/**
+ *  @brief The distribution of one sampled parameter or initial value.
+ *
+ *  The meaning of `a` and `b` depends on the distribution: they are the lower
+ *  and upper limits of a uniform distribution, the mean and standard
+ *  deviation of a normal distribution, or the mean and standard deviation of
+ *  the logarithm of a log-normal distribution.
+ */
+struct parameter_distribution {
+    enum class shape { uniform, normal, log_normal };
+
+    std::string name;
+    shape type;
+    double a;
+    double b;
+
+    double quantile(double p) const;
+};
+
+/**
+ *  @brief How the members of an ensemble are placed in parameter space.
+ *
+ *  With `random`, each member draws every parameter independently. With
+ *  `latin_hypercube`, the probability range of each parameter is divided into
+ *  one interval per member, and each interval is used by exactly one member.
+ */
+enum class sampling_design { random, latin_hypercube };
+
+/**
+ *  @brief Draws the parameter values of each ensemble member.
+ *
+ *  Each member has its own random number generator, seeded from `seed` and
+ *  the member's index, so the values of a member do not depend on how many
+ *  threads are used or on the order in which the members are run. With a
+ *  random design they also do not depend on the number of members; a Latin
+ *  hypercube design additionally uses one permutation per parameter that is
+ *  drawn from `seed` and depends on the number of members.
+ *
+ *  Values are drawn by inverse transform sampling with generators and
+ *  conversions that are fully specified by the C++ standard or defined here,
+ *  so a seed gives the same values with every compiler.
+ *
+ *  @return A vector with one element per member, each holding one value per
+ *          distribution
+ */
+std::vector<std::vector<double>> sample_parameters(
+    std::vector<parameter_distribution> const& distributions,
+    size_t members,
+    sampling_design design,
+    uint64_t seed);
+
+/**
+ *  @brief Per-time-point statistics of a set of simulation outputs that are
+ *  added one ensemble member at a time.
+ *
+ *  For each time point and quantity, the mean and variance are updated with
+ *  Welford's algorithm, and the minimum and maximum are tracked. Quantiles
+ *  are estimated from a merging t-digest: each sketch holds at most about
+ *  `2 * compression` weighted centroids, which are merged using the arcsine
+ *  scale function so that the tails are represented more finely than the
+ *  center. Until a sketch needs to be merged, it holds every value, and the
+ *  quantiles are exact and equal to R's `quantile(x, type = 5)`.
+ *
+ *  The memory required is proportional to the number of time points times
+ *  the number of quantities and does not depend on the number of members.
+ *  If any member produces a NaN for a time point and quantity, all of its
+ *  statistics are NaN.
+ */
+class ensemble_statistics
+{
+   public:
+    ensemble_statistics(string_vector const& quantities, double compression);
+
+    void add_member(state_vector_map const& result);
+
+    string_vector const& get_quantities() const { return quantities; }
+    size_t get_members() const { return members; }
+    size_t get_ntimes() const { return ntimes; }
+
+    double mean(size_t time, size_t quantity) const;
+    double variance(size_t time, size_t quantity) const;
+    double minimum(size_t time, size_t quantity) const;
+    double maximum(size_t time, size_t quantity) const;
+    double quantile(size_t time, size_t quantity, double p) const;
+
+   private:
+    struct centroid {
+        double mean;
+        double weight;
+    };
+
+    struct cell {
+        double mean;
+        double m2;
+        double minimum;
+        double maximum;
+        bool has_nan;
+        std::vector<centroid> centroids;
+    };
+
+    string_vector quantities;  // set by the first member if empty
+    double const compression;
+    size_t const sketch_capacity;
+    size_t members = 0;
+    size_t ntimes = 0;
+
+    // One cell for each time point and quantity, with the time points of
+    // each quantity stored together
+    std::vector<cell> cells;
+
+    cell const& at(size_t time, size_t quantity) const;
+    void merge(std::vector<centroid>& centroids) const;
+};
+
+/**
+ *  @brief Runs one simulation for each row of `samples` and returns the
+ *  statistics of the requested quantities.
+ *
+ *  The arguments up to `adaptive_max_steps` have the same meaning as the
+ *  arguments of the `biocro_simulation` constructor. For each member, the
+ *  values in its row of `samples` replace the parameters or initial values
+ *  named by `sampled_names` before its system is built.
+ *
+ *  Up to `nthreads` members are simulated at once, each with its own
+ *  `biocro_simulation`. The results are added to the statistics in member
+ *  order, so the statistics do not depend on the number of threads. Only
+ *  the results of the members that are running or waiting to be added are
+ *  held in memory at any time.
+ *
+ *  @param [in] quantities The quantities to summarize; if this is empty,
+ *              every quantity in the simulation result is summarized
+ */
+ensemble_statistics run_ensemble(
+    state_map const& initial_values,
+    state_map const& parameters,
+    state_vector_map const& drivers,
+    mc_vector const& direct_mcs,
+    mc_vector const& differential_mcs,
+    std::string const& ode_solver_name,
+    double output_step_size,
+    double adaptive_rel_error_tol,
+    double adaptive_abs_error_tol,
+    int adaptive_max_steps,
+    string_vector const& sampled_names,
+    std::vector<std::vector<double>> const& samples,
+    string_vector const& quantities,
+    double compression,
+    int nthreads);
+
+}  // namespace BioCroWP
+
+#endif
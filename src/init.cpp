@@ -21,6 +21,14 @@
 #include "R_skeleton_version.h"
 #include "R_framework_version.h"
 
+// BioCroWP deliberately departs from the skeleton's template for this file by
+// registering `R_evaluate_module_batch` and `R_run_ensemble`. Running
+// `script/module_library_setup.R` replaces this file with the template, so
+// these includes and their `callMethods` entries must then be restored; see
+// "Changes to skeleton files" in README.md.
+#include "R_module_batch.h"
+#include "R_ensemble.h"
+
 extern "C" {
 static const R_CallMethodDef callMethods[] = {
     {"R_get_all_modules",        (DL_FUNC) &R_get_all_modules,        0},
@@ -28,6 +36,9 @@ static const R_CallMethodDef callMethods[] = {
     {"R_module_creators",        (DL_FUNC) &R_module_creators,        1},
     {"R_skeleton_version",       (DL_FUNC) &R_skeleton_version,       0},
     {"R_framework_version",      (DL_FUNC) &R_framework_version,      0},
+    // Not part of the skeleton template; see the note above
+    {"R_evaluate_module_batch",  (DL_FUNC) &R_evaluate_module_batch,  3},
+    {"R_run_ensemble",           (DL_FUNC) &R_run_ensemble,           18},
     {NULL,                       NULL,                                0}
 };
 
@@ -0,0 +1,101 @@
+#ifndef BioCroWP_CREATOR_TABLE_H
+#define BioCroWP_CREATOR_TABLE_H
+
+#include <cstddef>    // for size_t
+#include <cstring>    // for std::strcmp
+#include <stdexcept>  // for std::out_of_range
+#include <string>
+#include "../framework/module_creator.h"  // for creator_fcn
+
+namespace BioCroWP
+{
+/**
+ * @brief One row of a `creator_table`.
+ *
+ * The member names match those of `std::pair` so that code written for a
+ * `creator_map`, such as `module_factory<T>::get_all_modules()`, can iterate
+ * over a table without modification.
+ */
+struct creator_table_entry {
+    char const* first;
+    creator_fcn second;
+};
+
+/**
+ * @brief Compares two C strings byte by byte; usable in constant expressions.
+ *
+ * This gives the same ordering as `std::strcmp(a, b) < 0`.
+ */
+constexpr bool creator_name_less(char const* a, char const* b)
+{
+    return *a == *b
+               ? (*a != '\0' && creator_name_less(a + 1, b + 1))
+               : static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+}
+
+/**
+ * @brief Checks that the names in a list of entries are strictly increasing,
+ * which also rules out duplicate module names.
+ */
+constexpr bool creator_entries_are_sorted(creator_table_entry const* entries, size_t n)
+{
+    return n < 2 ||
+           (creator_name_less(entries[0].first, entries[1].first) &&
+            creator_entries_are_sorted(entries + 1, n - 1));
+}
+
+/**
+ * @class creator_table
+ *
+ * @brief A read-only, sorted table of module names and `creator_fcn` pointers.
+ *
+ * A `creator_table` is a drop-in replacement for the `creator_map` normally
+ * used for `module_library::library_entries`: it provides the `at()` lookup
+ * and the iteration used by `module_factory`. Unlike a `std::map`, it does not
+ * allocate anything. It only refers to a constant array of entries, and its
+ * constructor is `constexpr`, so a static table is constant-initialized rather
+ * than being built when the shared library is loaded.
+ *
+ * The entries must be sorted by name (see `creator_entries_are_sorted()`),
+ * since lookups are performed by binary search.
+ */
+class creator_table
+{
+   public:
+    template <size_t N>
+    constexpr creator_table(creator_table_entry const (&entries)[N])
+        : entries{entries},
+          n{N}
+    {
+    }
+
+    creator_fcn at(std::string const& module_name) const
+    {
+        size_t lo = 0;
+        size_t hi = n;
+        while (lo < hi) {
+            size_t const mid = lo + (hi - lo) / 2;
+            int const c = std::strcmp(entries[mid].first, module_name.c_str());
+            if (c == 0) {
+                return entries[mid].second;
+            } else if (c < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        throw std::out_of_range(module_name);
+    }
+
+    creator_table_entry const* begin() const { return entries; }
+    creator_table_entry const* end() const { return entries + n; }
+    size_t size() const { return n; }
+
+   private:
+    creator_table_entry const* entries;
+    size_t n;
+};
+
+}  // namespace BioCroWP
+
+#endif
@@ -0,0 +1,194 @@
+#include <algorithm>  // for std::max
+#include <cmath>      // for std::floor
+#include <stdexcept>  // for std::out_of_range
+#include <string>
+#include "../framework/module_helper_functions.h"  // for get_ip and get_op
+#include "hydraulic_network.h"
+
+using BioCroWP::hydraulic_network;
+
+namespace
+{
+// Density of water, the same value used by pressure_potential
+double const pw = 998200;  // g / m3
+
+// Returns {name_1, name_2, ..., name_n}
+string_vector numbered_names(std::string const& name, int n)
+{
+    string_vector names;
+    for (int i = 1; i <= n; i++) {
+        names.push_back(name + "_" + std::to_string(i));
+    }
+    return names;
+}
+
+// Appends the contents of `b` to `a`
+void append(string_vector& a, string_vector const& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+}
+
+// Converts the value of an `edge_source_k` or `edge_target_k` quantity to a
+// zero-based node index
+int node_index(state_map const& input_quantities, std::string const& name, int nnodes)
+{
+    double const node = get_input(input_quantities, name);
+    if (node != std::floor(node) || node < 1 || node > nnodes) {
+        throw std::out_of_range(
+            std::string("Thrown by hydraulic_network: the value of '") + name +
+            "' is not a node number between 1 and " + std::to_string(nnodes));
+    }
+    return static_cast<int>(node) - 1;
+}
+}  // namespace
+
+hydraulic_network::hydraulic_network(
+    int nnodes,
+    int nedges,
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : differential_module(),
+
+      // Store the number of nodes and edges
+      nnodes{nnodes},
+      nedges{nedges},
+
+      // Get references to input quantities
+      wp_crit{get_input(input_quantities, "wp_crit")},
+
+      node_pressure_potential_ip{get_ip(input_quantities, numbered_names("node_pressure_potential", nnodes))},
+      node_osmotic_potential_ip{get_ip(input_quantities, numbered_names("node_osmotic_potential", nnodes))},
+      node_volume_ip{get_ip(input_quantities, numbered_names("node_volume", nnodes))},
+      node_water_supply_ip{get_ip(input_quantities, numbered_names("node_water_supply", nnodes))},
+      node_extensibility_ip{get_ip(input_quantities, numbered_names("node_extensibility", nnodes))},
+      node_elastic_modulus_ip{get_ip(input_quantities, numbered_names("node_elastic_modulus", nnodes))},
+
+      edge_resistance_ip{get_ip(input_quantities, numbered_names("edge_resistance", nedges))},
+
+      // Allocate storage for intermediate values
+      total_potential(nnodes),
+      conductance(nedges),
+
+      // Get pointers to output quantities
+      node_pressure_potential_op{get_op(output_quantities, numbered_names("node_pressure_potential", nnodes))},
+      node_water_content_op{get_op(output_quantities, numbered_names("node_water_content", nnodes))},
+      node_volume_op{get_op(output_quantities, numbered_names("node_volume", nnodes))}
+{
+    // Read the topology
+    string_vector const source_names = numbered_names("edge_source", nedges);
+    string_vector const target_names = numbered_names("edge_target", nedges);
+
+    // Modules are created with all quantities set to zero when a system is
+    // validated, so a topology with no node numbers at all is accepted and
+    // treated as node 1; otherwise every node number must be valid
+    bool topology_unset = true;
+    for (int k = 0; k < nedges; ++k) {
+        topology_unset = topology_unset &&
+                         get_input(input_quantities, source_names[k]) == 0 &&
+                         get_input(input_quantities, target_names[k]) == 0;
+    }
+
+    std::vector<int> source(nedges, 0);
+    std::vector<int> target(nedges, 0);
+    if (!topology_unset) {
+        for (int k = 0; k < nedges; ++k) {
+            source[k] = node_index(input_quantities, source_names[k], nnodes);
+            target[k] = node_index(input_quantities, target_names[k], nnodes);
+        }
+    }
+
+    // Count the edges that meet at each node, then fill in the compressed
+    // adjacency lists
+    adjacency_offset.assign(nnodes + 1, 0);
+    for (int k = 0; k < nedges; ++k) {
+        ++adjacency_offset[source[k] + 1];
+        ++adjacency_offset[target[k] + 1];
+    }
+
+    for (int i = 0; i < nnodes; ++i) {
+        adjacency_offset[i + 1] += adjacency_offset[i];
+    }
+
+    adjacent_node.resize(2 * nedges);
+    adjacent_edge.resize(2 * nedges);
+
+    std::vector<int> position(adjacency_offset.begin(), adjacency_offset.end() - 1);
+    for (int k = 0; k < nedges; ++k) {
+        adjacent_node[position[source[k]]] = target[k];
+        adjacent_edge[position[source[k]]++] = k;
+
+        adjacent_node[position[target[k]]] = source[k];
+        adjacent_edge[position[target[k]]++] = k;
+    }
+}
+
+string_vector hydraulic_network::get_inputs(int nnodes, int nedges)
+{
+    string_vector inputs = {
+        "wp_crit"  // MPa
+    };
+
+    append(inputs, numbered_names("node_pressure_potential", nnodes));  // MPa
+    append(inputs, numbered_names("node_osmotic_potential", nnodes));   // MPa
+    append(inputs, numbered_names("node_volume", nnodes));              // m3
+    append(inputs, numbered_names("node_water_supply", nnodes));        // Mg / ha / hr
+    append(inputs, numbered_names("node_extensibility", nnodes));       // MPa-1 hr-1
+    append(inputs, numbered_names("node_elastic_modulus", nnodes));     // MPa
+
+    append(inputs, numbered_names("edge_source", nedges));      // dimensionless
+    append(inputs, numbered_names("edge_target", nedges));      // dimensionless
+    append(inputs, numbered_names("edge_resistance", nedges));  // MPa hr ha / g
+
+    return inputs;
+}
+
+string_vector hydraulic_network::get_outputs(int nnodes)
+{
+    string_vector outputs;
+
+    append(outputs, numbered_names("node_pressure_potential", nnodes));  // MPa / hr
+    append(outputs, numbered_names("node_water_content", nnodes));       // g / ha / hr
+    append(outputs, numbered_names("node_volume", nnodes));              // m3 / hr
+
+    return outputs;
+}
+
+void hydraulic_network::do_operation() const
+{
+    for (int i = 0; i < nnodes; ++i) {
+        total_potential[i] = *node_pressure_potential_ip[i] + *node_osmotic_potential_ip[i];
+    }
+
+    for (int k = 0; k < nedges; ++k) {
+        if (!(*edge_resistance_ip[k] > 0)) {
+            throw std::out_of_range(
+                "Thrown by hydraulic_network: the value of 'edge_resistance_" +
+                std::to_string(k + 1) + "' is not positive");
+        }
+        conductance[k] = 1.0 / *edge_resistance_ip[k];
+    }
+
+    for (int i = 0; i < nnodes; ++i) {
+        // Net water inflow to this node, converting the exchange with the
+        // surroundings from Mg/(ha*hr) to g/(ha*hr)
+        double dW = *node_water_supply_ip[i] * 1000000;  // g ha-1 hr-1
+        for (int j = adjacency_offset[i]; j < adjacency_offset[i + 1]; ++j) {
+            dW += (total_potential[adjacent_node[j]] - total_potential[i]) *
+                  conductance[adjacent_edge[j]];
+        }
+
+        // Change in pressure potential accounts for both elastic and plastic
+        // growth
+        double const V = *node_volume_ip[i];
+        double const e = *node_extensibility_ip[i];
+        double const eps = *node_elastic_modulus_ip[i];
+        double const growth = e * (std::max(*node_pressure_potential_ip[i], wp_crit) - wp_crit);
+
+        double const dP = (dW / (pw * V) - growth) * eps;  // MPa hr-1
+        double const dV = V * (dP / eps + growth);          // m3 hr-1
+
+        update(node_pressure_potential_op[i], dP);
+        update(node_water_content_op[i], dW);
+        update(node_volume_op[i], dV);
+    }
+}
@@ -0,0 +1,208 @@
+#ifndef BioCroWP_HYDRAULIC_NETWORK_H
+#define BioCroWP_HYDRAULIC_NETWORK_H
+
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+
+namespace BioCroWP
+{
+/**
+ * @class hydraulic_network
+ *
+ * @brief Calculates water flows, pressure potentials, and organ growth for a
+ * plant hydraulic network with an arbitrary topology.
+ *
+ * This generalizes `pressure_potential` from a fixed root-stem-leaf chain to
+ * `nnodes` hydraulic nodes (e.g., fine and coarse roots, stem segments,
+ * branches, and leaf cohorts) connected by `nedges` resistances. The two
+ * numbers are independent, so the edges may form a tree, contain cycles (such
+ * as parallel pathways between two nodes), or connect a node to itself; an
+ * edge from a node to itself carries no flow, so it can be used for edges
+ * that are not needed. Nodes and edges are numbered from 1, and all of their
+ * quantities have names ending in that number; e.g.,
+ * `node_pressure_potential_2` or `edge_resistance_1`.
+ *
+ * Each edge `k` connects node `edge_source_k` to node `edge_target_k` through
+ * `edge_resistance_k` (MPa hr ha / g), which must be positive, and the water
+ * flow from the source to the target is driven by the difference in total
+ * (pressure plus osmotic) potential. Each node may also exchange water with its surroundings at the
+ * rate `node_water_supply_i` (Mg / ha / hr), which is positive for uptake from
+ * the soil and negative for transpiration. The net inflow `dW` to each node
+ * then changes its pressure potential, water content, and volume as in
+ * `pressure_potential`:
+ *
+ *  dP = (dW / (pw * V) - e * (max(P, wp_crit) - wp_crit)) * eps
+ *
+ *  dV = V * (dP / eps + e * (max(P, wp_crit) - wp_crit))
+ *
+ * where `e` is `node_extensibility_i` (MPa-1 hr-1) and `eps` is
+ * `node_elastic_modulus_i` (MPa). The root, stem, and leaf of
+ * `pressure_potential` correspond to three nodes connected in a chain with
+ * extensibilities `ext_z + 2 * ext_x` (or `ext_z + ext_x + ext_y` for the
+ * leaf) and elastic moduli `mod_x * mod_z / (2 * mod_z + mod_x)`. Unlike
+ * `pressure_potential`, no node is prevented from losing water.
+ *
+ * The topology is read from the `edge_source_k` and `edge_target_k` values
+ * when the module is created and stored as a compressed sparse list of the
+ * edges that meet at each node, so the cost of each derivative calculation is
+ * proportional to the number of nodes plus the number of edges. Changes to
+ * these quantities after the module has been created have no effect. Each of
+ * them must be a node number between 1 and `nnodes`, unless they are all zero
+ * as they are when a system is validated.
+ *
+ * Modules for particular numbers of nodes are derived from this class; see
+ * `three_node_hydraulic_network` for an example.
+ */
+class hydraulic_network : public differential_module
+{
+   public:
+    hydraulic_network(
+        int nnodes,
+        int nedges,
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs(int nnodes, int nedges);
+    static string_vector get_outputs(int nnodes);
+
+   private:
+    // Number of nodes and edges
+    int const nnodes;
+    int const nedges;
+
+    // References to input quantities
+    double const& wp_crit;
+
+    std::vector<const double*> node_pressure_potential_ip;  // MPa
+    std::vector<const double*> node_osmotic_potential_ip;   // MPa
+    std::vector<const double*> node_volume_ip;              // m3
+    std::vector<const double*> node_water_supply_ip;        // Mg / ha / hr
+    std::vector<const double*> node_extensibility_ip;       // MPa-1 hr-1
+    std::vector<const double*> node_elastic_modulus_ip;     // MPa
+
+    std::vector<const double*> edge_resistance_ip;  // MPa hr ha / g
+
+    // Compressed sparse adjacency: the edges that meet at node `i` are
+    // `adjacent_edge[j]` for `adjacency_offset[i] <= j < adjacency_offset[i + 1]`,
+    // and `adjacent_node[j]` is the node at the other end of that edge
+    std::vector<int> adjacency_offset;
+    std::vector<int> adjacent_node;
+    std::vector<int> adjacent_edge;
+
+    // Storage for intermediate values, allocated once
+    mutable std::vector<double> total_potential;  // MPa
+    mutable std::vector<double> conductance;      // g / ha / hr / MPa
+
+    // Pointers to output quantities
+    std::vector<double*> node_pressure_potential_op;  // MPa / hr
+    std::vector<double*> node_water_content_op;       // g / ha / hr
+    std::vector<double*> node_volume_op;              // m3 / hr
+
+    // Main operation
+    void do_operation() const;
+};
+
+/**
+ * @class three_node_hydraulic_network
+ *
+ * @brief A `hydraulic_network` with three nodes and two edges, which can
+ * represent the root-stem-leaf chain of `pressure_potential`.
+ */
+class three_node_hydraulic_network : public hydraulic_network
+{
+   public:
+    three_node_hydraulic_network(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : hydraulic_network(nnodes, nedges, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return hydraulic_network::get_inputs(nnodes, nedges); }
+    static string_vector get_outputs() { return hydraulic_network::get_outputs(nnodes); }
+    static std::string get_name() { return "three_node_hydraulic_network"; }
+
+   private:
+    static int const nnodes = 3;
+    static int const nedges = 2;
+};
+
+/**
+ * @class ten_node_hydraulic_network
+ *
+ * @brief A `hydraulic_network` with ten nodes and nine edges, which is enough
+ * to connect the nodes as a tree. The connections are set by the
+ * `edge_source_k` and `edge_target_k` inputs; whether they form a tree is not
+ * checked.
+ */
+class ten_node_hydraulic_network : public hydraulic_network
+{
+   public:
+    ten_node_hydraulic_network(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : hydraulic_network(nnodes, nedges, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return hydraulic_network::get_inputs(nnodes, nedges); }
+    static string_vector get_outputs() { return hydraulic_network::get_outputs(nnodes); }
+    static std::string get_name() { return "ten_node_hydraulic_network"; }
+
+   private:
+    static int const nnodes = 10;
+    static int const nedges = 9;
+};
+
+/**
+ * @class hundred_node_hydraulic_network
+ *
+ * @brief A `hydraulic_network` with one hundred nodes and ninety-nine edges,
+ * which is enough to connect the nodes as a tree. The connections are set by
+ * the `edge_source_k` and `edge_target_k` inputs; whether they form a tree is
+ * not checked.
+ */
+class hundred_node_hydraulic_network : public hydraulic_network
+{
+   public:
+    hundred_node_hydraulic_network(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : hydraulic_network(nnodes, nedges, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return hydraulic_network::get_inputs(nnodes, nedges); }
+    static string_vector get_outputs() { return hydraulic_network::get_outputs(nnodes); }
+    static std::string get_name() { return "hundred_node_hydraulic_network"; }
+
+   private:
+    static int const nnodes = 100;
+    static int const nedges = 99;
+};
+
+/**
+ * @class ten_node_twenty_edge_hydraulic_network
+ *
+ * @brief A `hydraulic_network` with ten nodes and twenty edges, which is
+ * enough for a tree with eleven additional connections, e.g., leaves that are
+ * supplied by more than one branch or parallel pathways between two nodes.
+ */
+class ten_node_twenty_edge_hydraulic_network : public hydraulic_network
+{
+   public:
+    ten_node_twenty_edge_hydraulic_network(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : hydraulic_network(nnodes, nedges, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return hydraulic_network::get_inputs(nnodes, nedges); }
+    static string_vector get_outputs() { return hydraulic_network::get_outputs(nnodes); }
+    static std::string get_name() { return "ten_node_twenty_edge_hydraulic_network"; }
+
+   private:
+    static int const nnodes = 10;
+    static int const nedges = 20;
+};
+
+}  // namespace BioCroWP
+#endif
@@ -0,0 +1,36 @@
+#ifndef BioCroWP_HYDRAULIC_POTENTIAL_PIPELINE_H
+#define BioCroWP_HYDRAULIC_POTENTIAL_PIPELINE_H
+
+#include "static_module_pipeline.h"
+#include "soil_temperature.h"
+#include "soil_potential.h"
+#include "osmotic_potential.h"
+#include "total_potential.h"
+
+namespace BioCroWP
+{
+/**
+ * @class hydraulic_potential_pipeline
+ *
+ * @brief The direct modules used by the standard BioCroWP configuration,
+ * compiled into a single module.
+ *
+ * This runs `soil_temperature`, `soil_potential`, `osmotic_potential`, and
+ * `total_potential` in that order and produces all of their outputs. It can
+ * replace those four modules in a list of direct modules. See
+ * `static_module_pipeline` for more details.
+ */
+class hydraulic_potential_pipeline
+    : public static_module_pipeline<
+          soil_temperature,
+          soil_potential,
+          osmotic_potential,
+          total_potential>
+{
+   public:
+    using static_module_pipeline::static_module_pipeline;
+    static std::string get_name() { return "hydraulic_potential_pipeline"; }
+};
+
+}  // namespace BioCroWP
+#endif
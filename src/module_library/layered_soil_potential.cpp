@@ -0,0 +1,80 @@
+#include "../framework/module_helper_functions.h"  // for get_multilayer_ip, get_multilayer_op
+#include "van_genuchten.h"
+#include "layered_soil_potential.h"
+
+using BioCroWP::layered_soil_potential;
+namespace vg = BioCroWP::van_genuchten;
+
+namespace
+{
+// Head (cm) to potential (MPa), the same value used by soil_potential
+double const convf = 0.0000979;  // MPa / cm
+
+string_vector const layer_quantities = {
+    "soil_water_content",  // dimensionless
+    "soil_depth",          // cm
+    "soil_alpha",          // cm-1
+    "soil_n",              // dimensionless
+    "soil_m",              // dimensionless
+    "soil_residual_wc",    // dimensionless
+    "soil_saturated_wc"    // dimensionless
+};
+}  // namespace
+
+layered_soil_potential::layered_soil_potential(
+    int nlayers,
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : direct_module(),
+
+      // Store the number of layers
+      nlayers{nlayers},
+
+      // Get references to input quantities
+      soil_water_content_ip{get_multilayer_ip(input_quantities, nlayers, "soil_water_content")},
+      soil_depth_ip{get_multilayer_ip(input_quantities, nlayers, "soil_depth")},
+      soil_alpha_ip{get_multilayer_ip(input_quantities, nlayers, "soil_alpha")},
+      soil_n_ip{get_multilayer_ip(input_quantities, nlayers, "soil_n")},
+      soil_m_ip{get_multilayer_ip(input_quantities, nlayers, "soil_m")},
+      soil_residual_wc_ip{get_multilayer_ip(input_quantities, nlayers, "soil_residual_wc")},
+      soil_saturated_wc_ip{get_multilayer_ip(input_quantities, nlayers, "soil_saturated_wc")},
+
+      // Get pointers to output quantities
+      soil_pressure_potential_op{get_multilayer_op(output_quantities, nlayers, "soil_pressure_potential")},
+      soil_potential_op{get_multilayer_op(output_quantities, nlayers, "soil_potential")}
+{
+}
+
+string_vector layered_soil_potential::get_inputs(int nlayers)
+{
+    return generate_multilayer_quantity_names(nlayers, layer_quantities);
+}
+
+string_vector layered_soil_potential::get_outputs(int nlayers)
+{
+    return generate_multilayer_quantity_names(
+        nlayers,
+        {
+            "soil_pressure_potential",  // MPa
+            "soil_potential"            // MPa
+        });
+}
+
+void layered_soil_potential::do_operation() const
+{
+    double depth = 0.0;  // cm, depth of the top of the current layer
+    for (int i = 0; i < nlayers; ++i) {
+        double const Se = vg::effective_saturation(
+            *soil_water_content_ip[i], *soil_residual_wc_ip[i], *soil_saturated_wc_ip[i]);
+
+        double const pressure_potential =
+            convf * vg::head(Se, *soil_alpha_ip[i], *soil_n_ip[i], *soil_m_ip[i]);  // MPa
+
+        double const gravitational_potential = -convf * (depth + *soil_depth_ip[i] / 2);  // MPa
+
+        depth += *soil_depth_ip[i];
+
+        update(soil_pressure_potential_op[i], pressure_potential);
+        update(soil_potential_op[i], pressure_potential + gravitational_potential);
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef BioCroWP_LAYERED_SOIL_POTENTIAL_H
+#define BioCroWP_LAYERED_SOIL_POTENTIAL_H
+
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+
+namespace BioCroWP
+{
+/**
+ * @class layered_soil_potential
+ *
+ * @brief Calculates the water potentials of `nlayers` soil layers.
+ *
+ * This applies the calculation of `soil_potential` to any number of layers,
+ * named with the multilayer convention used by `richards_soil_water`. The
+ * pressure (matric) potential of each layer is found from its water content
+ * with the van Genuchten (1980) relation, and the total potential adds the
+ * gravitational potential at the middle of the layer. Unlike
+ * `soil_potential`, the effective saturation is limited to the range between
+ * 0 and 1, so layers at or above saturation have a pressure potential of 0
+ * rather than an undefined value, and the layer depths are converted to
+ * potentials with the same factor as the heads (0.0000979 MPa per cm), whereas
+ * `soil_potential` applies that factor to depths in m.
+ *
+ * Modules for particular numbers of layers are derived from this class; see
+ * `fifty_layer_soil_potential` for an example.
+ */
+class layered_soil_potential : public direct_module
+{
+   public:
+    layered_soil_potential(
+        int nlayers,
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs(int nlayers);
+    static string_vector get_outputs(int nlayers);
+
+   private:
+    // Number of layers
+    int const nlayers;
+
+    // References to input quantities
+    std::vector<const double*> soil_water_content_ip;  // dimensionless
+    std::vector<const double*> soil_depth_ip;          // cm
+    std::vector<const double*> soil_alpha_ip;          // cm-1
+    std::vector<const double*> soil_n_ip;              // dimensionless
+    std::vector<const double*> soil_m_ip;              // dimensionless
+    std::vector<const double*> soil_residual_wc_ip;    // dimensionless
+    std::vector<const double*> soil_saturated_wc_ip;   // dimensionless
+
+    // Pointers to output quantities
+    std::vector<double*> soil_pressure_potential_op;  // MPa
+    std::vector<double*> soil_potential_op;           // MPa
+
+    // Main operation
+    void do_operation() const;
+};
+
+/**
+ * @class fifty_layer_soil_potential
+ *
+ * @brief A `layered_soil_potential` module with fifty soil layers.
+ */
+class fifty_layer_soil_potential : public layered_soil_potential
+{
+   public:
+    fifty_layer_soil_potential(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_potential(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_potential::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_potential::get_outputs(nlayers); }
+    static std::string get_name() { return "fifty_layer_soil_potential"; }
+
+   private:
+    static int const nlayers = 50;
+};
+
+/**
+ * @class hundred_layer_soil_potential
+ *
+ * @brief A `layered_soil_potential` module with one hundred soil layers.
+ */
+class hundred_layer_soil_potential : public layered_soil_potential
+{
+   public:
+    hundred_layer_soil_potential(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_potential(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_potential::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_potential::get_outputs(nlayers); }
+    static std::string get_name() { return "hundred_layer_soil_potential"; }
+
+   private:
+    static int const nlayers = 100;
+};
+
+/**
+ * @class two_hundred_layer_soil_potential
+ *
+ * @brief A `layered_soil_potential` module with two hundred soil layers.
+ */
+class two_hundred_layer_soil_potential : public layered_soil_potential
+{
+   public:
+    two_hundred_layer_soil_potential(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_potential(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_potential::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_potential::get_outputs(nlayers); }
+    static std::string get_name() { return "two_hundred_layer_soil_potential"; }
+
+   private:
+    static int const nlayers = 200;
+};
+
+}  // namespace BioCroWP
+#endif
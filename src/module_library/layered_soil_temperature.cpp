@@ -0,0 +1,182 @@
+#include "../framework/module_helper_functions.h"  // for get_multilayer_ip, get_multilayer_op
+#include "soil_thermal_properties.h"               // for soil_thermal_conductivity, soil_heat_capacity
+#include "layered_soil_temperature.h"
+
+using BioCroWP::layered_soil_temperature;
+
+namespace
+{
+string_vector const layer_quantities = {
+    "soil_temperature",          // K
+    "soil_depth",                // cm
+    "soil_water_content",        // dimensionless
+    "soil_saturation_capacity",  // dimensionless
+    "soil_clay_content",         // % volume
+    "soil_type_indicator"        // dimensionless
+};
+}  // namespace
+
+layered_soil_temperature::layered_soil_temperature(
+    int nlayers,
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : differential_module(true),
+
+      // Store the number of layers
+      nlayers{nlayers},
+
+      // Get references to input quantities
+      timestep{get_input(input_quantities, "timestep")},
+      soil_surface_temperature{get_input(input_quantities, "soil_surface_temperature")},
+
+      soil_temperature_ip{get_multilayer_ip(input_quantities, nlayers, "soil_temperature")},
+      soil_depth_ip{get_multilayer_ip(input_quantities, nlayers, "soil_depth")},
+      soil_water_content_ip{get_multilayer_ip(input_quantities, nlayers, "soil_water_content")},
+      soil_saturation_capacity_ip{get_multilayer_ip(input_quantities, nlayers, "soil_saturation_capacity")},
+      soil_clay_content_ip{get_multilayer_ip(input_quantities, nlayers, "soil_clay_content")},
+      soil_type_indicator_ip{get_multilayer_ip(input_quantities, nlayers, "soil_type_indicator")},
+
+      // Allocate storage for intermediate values
+      factorized_inputs(1 + 5 * nlayers),
+      heat_capacity(nlayers),
+      conductance(nlayers),
+      temperature(nlayers),
+      system(nlayers),
+
+      // Get pointers to output quantities
+      soil_temperature_op{get_multilayer_op(output_quantities, nlayers, "soil_temperature")}
+{
+}
+
+string_vector layered_soil_temperature::get_inputs(int nlayers)
+{
+    string_vector inputs = {
+        "timestep",                 // hr
+        "soil_surface_temperature"  // K
+    };
+
+    string_vector const layers = generate_multilayer_quantity_names(nlayers, layer_quantities);
+    inputs.insert(inputs.end(), layers.begin(), layers.end());
+
+    return inputs;
+}
+
+string_vector layered_soil_temperature::get_outputs(int nlayers)
+{
+    return generate_multilayer_quantity_names(nlayers, {"soil_temperature"});  // K / hr
+}
+
+void layered_soil_temperature::do_operation() const
+{
+    double const dt = timestep;  // hr
+
+    if (!(dt > 0)) {
+        for (int i = 0; i < nlayers; ++i) {
+            update(soil_temperature_op[i], 0.0);
+        }
+        return;
+    }
+
+    if (!has_factorization || matrix_inputs_changed()) {
+        factorize();
+    }
+
+    // Right-hand side of the Crank-Nicolson step: the current heat content
+    // plus half of the current heat flows, with the surface temperature held
+    // over the step
+    for (int i = 0; i < nlayers; ++i) {
+        double const T = *soil_temperature_ip[i];
+        double const T_above = i == 0 ? soil_surface_temperature : *soil_temperature_ip[i - 1];
+
+        double rhs = heat_capacity[i] / dt * T - 0.5 * conductance[i] * (T - T_above);
+        if (i == 0) {
+            rhs += 0.5 * conductance[0] * soil_surface_temperature;
+        }
+        if (i < nlayers - 1) {
+            rhs -= 0.5 * conductance[i + 1] * (T - *soil_temperature_ip[i + 1]);
+        }
+
+        temperature[i] = rhs;
+    }
+
+    system.solve(temperature);
+
+    // Update the output quantity list
+    for (int i = 0; i < nlayers; ++i) {
+        update(soil_temperature_op[i], (temperature[i] - *soil_temperature_ip[i]) / dt);
+    }
+}
+
+/**
+ *  @brief Checks whether any input that affects the matrix differs from its
+ *  value when the matrix was last factorized.
+ *
+ *  The comparison is exact rather than within a tolerance: any change, however
+ *  small, causes the matrix to be factorized again, so reusing the stored
+ *  factorization gives the same result as calculating it anew.
+ */
+bool layered_soil_temperature::matrix_inputs_changed() const
+{
+    if (factorized_inputs[0] != timestep) {
+        return true;
+    }
+
+    for (int i = 0; i < nlayers; ++i) {
+        double const* stored = &factorized_inputs[1 + 5 * i];
+        if (stored[0] != *soil_depth_ip[i] ||
+            stored[1] != *soil_water_content_ip[i] ||
+            stored[2] != *soil_saturation_capacity_ip[i] ||
+            stored[3] != *soil_clay_content_ip[i] ||
+            stored[4] != *soil_type_indicator_ip[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *  @brief Calculates the layer heat capacities and conductances, then builds
+ *  and factorizes the Crank-Nicolson matrix.
+ */
+void layered_soil_temperature::factorize() const
+{
+    double const dt = timestep;  // hr
+
+    factorized_inputs[0] = dt;
+
+    double previous_resistance = 0.0;  // m2 hr K kJ-1, of the lower half of the layer above
+    for (int i = 0; i < nlayers; ++i) {
+        double* stored = &factorized_inputs[1 + 5 * i];
+        stored[0] = *soil_depth_ip[i];
+        stored[1] = *soil_water_content_ip[i];
+        stored[2] = *soil_saturation_capacity_ip[i];
+        stored[3] = *soil_clay_content_ip[i];
+        stored[4] = *soil_type_indicator_ip[i];
+
+        double const dz = *soil_depth_ip[i] / 100;  // m
+
+        double const k = soil_thermal_conductivity(
+            *soil_water_content_ip[i], *soil_saturation_capacity_ip[i],
+            *soil_clay_content_ip[i], *soil_type_indicator_ip[i]);  // kJ m-1 hr-1 K-1
+
+        heat_capacity[i] = soil_heat_capacity(
+                               *soil_water_content_ip[i], *soil_saturation_capacity_ip[i]) *
+                           dz;  // kJ m-2 K-1
+
+        double const half_resistance = dz / 2 / k;  // m2 hr K kJ-1
+        conductance[i] = 1.0 / (previous_resistance + half_resistance);
+        previous_resistance = half_resistance;
+    }
+
+    for (int i = 0; i < nlayers; ++i) {
+        double const below = i < nlayers - 1 ? conductance[i + 1] : 0.0;
+
+        system.lower[i] = -0.5 * conductance[i];
+        system.diagonal[i] = heat_capacity[i] / dt + 0.5 * (conductance[i] + below);
+        system.upper[i] = -0.5 * below;
+    }
+
+    system.factorize();
+    has_factorization = true;
+}
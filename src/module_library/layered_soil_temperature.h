@@ -0,0 +1,163 @@
+#ifndef BioCroWP_LAYERED_SOIL_TEMPERATURE_H
+#define BioCroWP_LAYERED_SOIL_TEMPERATURE_H
+
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+#include "tridiagonal_system.h"
+
+namespace BioCroWP
+{
+/**
+ * @class layered_soil_temperature
+ *
+ * @brief Calculates the change in temperature of `nlayers` soil layers by
+ * one-dimensional heat conduction.
+ *
+ * This is an alternative to `soil_temperature`, which describes each layer by
+ * a sinusoid driven by the daily air temperature range. Here the temperature
+ * of each layer is a state that exchanges heat with its neighbours, so any
+ * layering and any number of days of heat storage can be represented. Layers
+ * are numbered from 0 at the surface using the multilayer naming convention;
+ * e.g., `soil_temperature_layer_00` (K) is the top layer of a fifty-layer
+ * profile. Each layer has its own thickness `soil_depth` (cm), water content,
+ * porosity `soil_saturation_capacity`, clay content, and soil type indicator,
+ * from which its thermal conductivity (Cote and Konrad, 2005) and heat
+ * capacity (Hillel, 1982) are found exactly as in `soil_temperature`.
+ *
+ * The top layer exchanges heat with the surface, which is held at
+ * `soil_surface_temperature` (K) over each timestep, through half its
+ * thickness; no heat passes through the bottom of the profile, so the profile
+ * should be deep enough that the temperature at its base barely changes.
+ * Conductances between layers combine the two half-layers in series.
+ *
+ * The temperatures are advanced over one `timestep` with the Crank-Nicolson
+ * method, which is unconditionally stable and second order in time. Each step
+ * solves a tridiagonal system with the Thomas algorithm, so its cost is
+ * proportional to the number of layers. The matrix only depends on the
+ * timestep and the layer properties, so its factorization is kept and reused
+ * for as long as those inputs (in particular, the water contents) do not
+ * change. The stored inputs are compared exactly, so the factorization is
+ * only reused when a new one would be identical; the cache saves time but
+ * never changes the outputs. The output is the average rate of change over
+ * the timestep, so this module requires the Euler ODE solver.
+ *
+ * Modules for particular numbers of layers are derived from this class; see
+ * `fifty_layer_soil_temperature` for an example.
+ */
+class layered_soil_temperature : public differential_module
+{
+   public:
+    layered_soil_temperature(
+        int nlayers,
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs(int nlayers);
+    static string_vector get_outputs(int nlayers);
+
+   private:
+    // Number of layers
+    int const nlayers;
+
+    // References to input quantities
+    double const& timestep;
+    double const& soil_surface_temperature;
+
+    std::vector<const double*> soil_temperature_ip;          // K
+    std::vector<const double*> soil_depth_ip;                // cm
+    std::vector<const double*> soil_water_content_ip;        // dimensionless
+    std::vector<const double*> soil_saturation_capacity_ip;  // dimensionless
+    std::vector<const double*> soil_clay_content_ip;         // % volume
+    std::vector<const double*> soil_type_indicator_ip;       // dimensionless
+
+    // The inputs that determine the matrix when it was last factorized, in
+    // the order timestep, then for each layer: depth, water content,
+    // saturation capacity, clay content, and soil type indicator
+    mutable bool has_factorization = false;
+    mutable std::vector<double> factorized_inputs;
+
+    // Storage for intermediate values, allocated once
+    mutable std::vector<double> heat_capacity;  // kJ m-2 K-1, per unit area of each layer
+    mutable std::vector<double> conductance;    // kJ m-2 hr-1 K-1, above each layer
+    mutable std::vector<double> temperature;    // K
+    mutable tridiagonal_system system;
+
+    // Pointers to output quantities
+    std::vector<double*> soil_temperature_op;  // K / hr
+
+    // Main operation
+    void do_operation() const;
+
+    bool matrix_inputs_changed() const;
+    void factorize() const;
+};
+
+/**
+ * @class fifty_layer_soil_temperature
+ *
+ * @brief A `layered_soil_temperature` module with fifty soil layers.
+ */
+class fifty_layer_soil_temperature : public layered_soil_temperature
+{
+   public:
+    fifty_layer_soil_temperature(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_temperature(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_temperature::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_temperature::get_outputs(nlayers); }
+    static std::string get_name() { return "fifty_layer_soil_temperature"; }
+
+   private:
+    static int const nlayers = 50;
+};
+
+/**
+ * @class hundred_layer_soil_temperature
+ *
+ * @brief A `layered_soil_temperature` module with one hundred soil layers.
+ */
+class hundred_layer_soil_temperature : public layered_soil_temperature
+{
+   public:
+    hundred_layer_soil_temperature(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_temperature(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_temperature::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_temperature::get_outputs(nlayers); }
+    static std::string get_name() { return "hundred_layer_soil_temperature"; }
+
+   private:
+    static int const nlayers = 100;
+};
+
+/**
+ * @class two_hundred_layer_soil_temperature
+ *
+ * @brief A `layered_soil_temperature` module with two hundred soil layers.
+ */
+class two_hundred_layer_soil_temperature : public layered_soil_temperature
+{
+   public:
+    two_hundred_layer_soil_temperature(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : layered_soil_temperature(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return layered_soil_temperature::get_inputs(nlayers); }
+    static string_vector get_outputs() { return layered_soil_temperature::get_outputs(nlayers); }
+    static std::string get_name() { return "two_hundred_layer_soil_temperature"; }
+
+   private:
+    static int const nlayers = 200;
+};
+
+}  // namespace BioCroWP
+#endif
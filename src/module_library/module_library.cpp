@@ -8,13 +8,51 @@
 #include "osmotic_potential.h"
 #include "pressure_potential.h"
 #include "total_potential.h"
+#include "plant_hydraulics_fused.h"
+#include "hydraulic_potential_pipeline.h"
+#include "steady_state_pressure_potential.h"
+#include "hydraulic_network.h"
+#include "richards_soil_water.h"
+#include "layered_soil_potential.h"
+#include "layered_soil_temperature.h"
 
-creator_map BioCroWP::module_library::library_entries =
+namespace BioCroWP
+{
+namespace
+{
+// Entries must be listed in strictly increasing (byte-wise) order by name
+// because `creator_table::at()` uses a binary search; this is checked below.
+constexpr creator_table_entry entries[] =
 {
     {"example_module", &create_mc<example_module>},
-    {"soil_temperature", &create_mc<soil_temperature>},
-    {"soil_potential", &create_mc<soil_potential>},
+    {"fifty_layer_richards_soil_water", &create_mc<fifty_layer_richards_soil_water>},
+    {"fifty_layer_soil_potential", &create_mc<fifty_layer_soil_potential>},
+    {"fifty_layer_soil_temperature", &create_mc<fifty_layer_soil_temperature>},
+    {"hundred_layer_richards_soil_water", &create_mc<hundred_layer_richards_soil_water>},
+    {"hundred_layer_soil_potential", &create_mc<hundred_layer_soil_potential>},
+    {"hundred_layer_soil_temperature", &create_mc<hundred_layer_soil_temperature>},
+    {"hundred_node_hydraulic_network", &create_mc<hundred_node_hydraulic_network>},
+    {"hydraulic_potential_pipeline", &create_mc<hydraulic_potential_pipeline>},
     {"osmotic_potential", &create_mc<osmotic_potential>},
+    {"plant_hydraulics_fused", &create_mc<plant_hydraulics_fused>},
     {"pressure_potential", &create_mc<pressure_potential>},
-    {"total_potential", &create_mc<total_potential>}
+    {"soil_potential", &create_mc<soil_potential>},
+    {"soil_temperature", &create_mc<soil_temperature>},
+    {"steady_state_pressure_potential", &create_mc<steady_state_pressure_potential>},
+    {"ten_node_hydraulic_network", &create_mc<ten_node_hydraulic_network>},
+    {"ten_node_twenty_edge_hydraulic_network", &create_mc<ten_node_twenty_edge_hydraulic_network>},
+    {"three_node_hydraulic_network", &create_mc<three_node_hydraulic_network>},
+    {"total_potential", &create_mc<total_potential>},
+    {"two_hundred_layer_richards_soil_water", &create_mc<two_hundred_layer_richards_soil_water>},
+    {"two_hundred_layer_soil_potential", &create_mc<two_hundred_layer_soil_potential>},
+    {"two_hundred_layer_soil_temperature", &create_mc<two_hundred_layer_soil_temperature>}
 };
+
+static_assert(
+    creator_entries_are_sorted(entries, sizeof(entries) / sizeof(entries[0])),
+    "module_library entries must be sorted by name and must not repeat");
+}  // namespace
+
+creator_table const module_library::library_entries{entries};
+
+}  // namespace BioCroWP
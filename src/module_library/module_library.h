@@ -4,14 +4,14 @@
 #ifndef BioCroWP_MODULE_LIBRARY_H
 #define BioCroWP_MODULE_LIBRARY_H
 
-#include "../framework/module_creator.h"  // for module_creator and creator_map
+#include "creator_table.h"  // for creator_table
 
 namespace BioCroWP
 {
 class module_library
 {
    public:
-    static creator_map library_entries;
+    static creator_table const library_entries;
 };
 
 }  // namespace BioCroWP
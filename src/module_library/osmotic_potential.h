@@ -55,6 +55,10 @@ class osmotic_potential : public direct_module
 
     // Main operation
     void do_operation() const;
+
+    // Lets a static_module_pipeline call do_operation() without virtual dispatch
+    template <typename... Modules>
+    friend class static_module_pipeline;
 };
 
 }  // namespace BioCroWP
@@ -0,0 +1,199 @@
+#include <cmath>
+#include "../framework/module_helper_functions.h"  // for get_ip and get_op
+#include "plant_hydraulics_fused.h"
+
+using BioCroWP::plant_hydraulics_fused;
+
+namespace
+{
+// The soil modules in this library use a fixed set of six layers
+int const number_of_soil_layers = 6;
+
+// Returns {name_1, name_2, ..., name_6}, the naming convention used by the
+// soil modules in this library
+string_vector soil_layer_names(std::string const& name)
+{
+    string_vector names;
+    for (int l = 1; l <= number_of_soil_layers; l++) {
+        names.push_back(name + "_" + std::to_string(l));
+    }
+    return names;
+}
+
+// Appends the contents of `b` to `a`
+void append(string_vector& a, string_vector const& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+}
+}  // namespace
+
+plant_hydraulics_fused::plant_hydraulics_fused(
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : direct_module(),
+
+      // Get references to input quantities
+      max_rooting_layer{get_input(input_quantities, "max_rooting_layer")},
+
+      soil_n_ip{get_ip(input_quantities, soil_layer_names("soil_n"))},
+      soil_m_ip{get_ip(input_quantities, soil_layer_names("soil_m"))},
+      soil_alpha_ip{get_ip(input_quantities, soil_layer_names("soil_alpha"))},
+      soil_residual_wc_ip{get_ip(input_quantities, soil_layer_names("soil_residual_wc"))},
+      soil_saturated_wc_ip{get_ip(input_quantities, soil_layer_names("soil_saturated_wc"))},
+      soil_depth_ip{get_ip(input_quantities, soil_layer_names("soil_depth"))},
+      soil_water_content_ip{get_ip(input_quantities, soil_layer_names("soil_water_content"))},
+
+      leaf_temperature{get_input(input_quantities, "leaf_temperature")},
+      soil_temperature_avg{get_input(input_quantities, "soil_temperature_avg")},
+
+      root_volume{get_input(input_quantities, "root_volume")},
+      stem_volume{get_input(input_quantities, "stem_volume")},
+      leaf_volume{get_input(input_quantities, "leaf_volume")},
+
+      storage_water_frac{get_input(input_quantities, "storage_water_frac")},
+
+      root_pressure_potential{get_input(input_quantities, "root_pressure_potential")},
+      stem_pressure_potential{get_input(input_quantities, "stem_pressure_potential")},
+      leaf_pressure_potential{get_input(input_quantities, "leaf_pressure_potential")},
+
+      // Get pointers to output quantities
+      soil_potential_op{get_op(output_quantities, soil_layer_names("soil_potential"))},
+      soil_potential_avg_op{get_op(output_quantities, "soil_potential_avg")},
+
+      soil_pressure_potential_op{get_op(output_quantities, soil_layer_names("soil_pressure_potential"))},
+      soil_pressure_potential_avg_op{get_op(output_quantities, "soil_pressure_potential_avg")},
+
+      root_osmotic_potential_op{get_op(output_quantities, "root_osmotic_potential")},
+      stem_osmotic_potential_op{get_op(output_quantities, "stem_osmotic_potential")},
+      leaf_osmotic_potential_op{get_op(output_quantities, "leaf_osmotic_potential")},
+
+      root_total_potential_op{get_op(output_quantities, "root_total_potential")},
+      stem_total_potential_op{get_op(output_quantities, "stem_total_potential")},
+      leaf_total_potential_op{get_op(output_quantities, "leaf_total_potential")}
+{
+}
+
+string_vector plant_hydraulics_fused::get_inputs()
+{
+    string_vector inputs = {
+        "max_rooting_layer"  // dimensionless
+    };
+
+    append(inputs, soil_layer_names("soil_n"));              // dimensionless
+    append(inputs, soil_layer_names("soil_m"));              // dimensionless
+    append(inputs, soil_layer_names("soil_alpha"));          // cm-1
+    append(inputs, soil_layer_names("soil_residual_wc"));    // dimensionless
+    append(inputs, soil_layer_names("soil_saturated_wc"));   // dimensionless
+    append(inputs, soil_layer_names("soil_depth"));          // cm
+    append(inputs, soil_layer_names("soil_water_content"));  // cm3 [water] / cm3 [soil]
+
+    append(inputs, {
+                       "leaf_temperature",         // K
+                       "soil_temperature_avg",     // K
+                       "root_volume",              // m3
+                       "stem_volume",              // m3
+                       "leaf_volume",              // m3
+                       "storage_water_frac",       // dimensionless
+                       "root_pressure_potential",  // MPa
+                       "stem_pressure_potential",  // MPa
+                       "leaf_pressure_potential"   // MPa
+                   });
+
+    return inputs;
+}
+
+string_vector plant_hydraulics_fused::get_outputs()
+{
+    string_vector outputs = soil_layer_names("soil_potential");  // MPa
+    outputs.push_back("soil_potential_avg");                     // MPa
+
+    append(outputs, soil_layer_names("soil_pressure_potential"));  // MPa
+    outputs.push_back("soil_pressure_potential_avg");              // MPa
+
+    append(outputs, {
+                        "root_osmotic_potential",  // MPa
+                        "stem_osmotic_potential",  // MPa
+                        "leaf_osmotic_potential",  // MPa
+                        "root_total_potential",    // MPa
+                        "stem_total_potential",    // MPa
+                        "leaf_total_potential"     // MPa
+                    });
+
+    return outputs;
+}
+
+void plant_hydraulics_fused::do_operation() const
+{
+    // Soil potential; see soil_potential.cpp for a description of each step
+    double soil_depth[number_of_soil_layers];  // m
+    for (int l = 0; l < number_of_soil_layers; l++) {
+        soil_depth[l] = *soil_depth_ip[l] / 100;
+    }
+
+    double pressure_potential[number_of_soil_layers] = {0};
+    double gravitational_potential[number_of_soil_layers] = {0};
+    double total_potential[number_of_soil_layers] = {0};
+    double tot_soil_depth[number_of_soil_layers] = {soil_depth[0], 0, 0, 0, 0, 0};
+
+    double convf = 0.0000979;  // head (m) to potential (MPa)
+
+    for (int l = 1; l < max_rooting_layer; l++) {
+        tot_soil_depth[l] = tot_soil_depth[l - 1] + soil_depth[l];
+    }
+
+    for (int l = 0; l < max_rooting_layer; l++) {
+        double const soil_wc = *soil_water_content_ip[l];
+        double const soil_residual_wc = *soil_residual_wc_ip[l];
+        pressure_potential[l] = -convf * (1.0 / *soil_alpha_ip[l]) * pow((pow(((*soil_saturated_wc_ip[l] - soil_residual_wc) / (soil_wc - soil_residual_wc)),
+                                                                            (1.0 / *soil_m_ip[l])) -
+                                                                        1.0),
+                                                                       (1.0 / *soil_n_ip[l]));  // MPa
+        gravitational_potential[l] = convf * (0 - (tot_soil_depth[l] - (soil_depth[l] / 2)));
+        total_potential[l] = pressure_potential[l] + gravitational_potential[l];
+    }
+
+    double num = 0.0;
+    double denom = 0.0;
+    for (int l = 0; l < max_rooting_layer; l++) {
+        num += *soil_water_content_ip[l] * soil_depth[l] * total_potential[l];
+        denom += *soil_water_content_ip[l] * soil_depth[l];
+    }
+
+    // `soil_potential` computes this average a second time in a separate loop
+    // with identical terms, so the same value can be reused here
+    double volumetric_avg = num / denom;
+    double volumetric_pressure_avg = volumetric_avg;
+
+    // Osmotic potential; see osmotic_potential.cpp
+    double M_sucrose = 342.3;           // g/mol
+    double R = 8.31446261815324;        // J*k-1*mol-1
+
+    double m_sucrose_root = 0.1 * root_volume;
+    double m_sucrose_stem = 0.1 * stem_volume;
+    double m_sucrose_leaf = 0.1 * leaf_volume;
+
+    double root_storage_water = storage_water_frac * root_volume;  // m3
+    double stem_storage_water = storage_water_frac * stem_volume;
+    double leaf_storage_water = storage_water_frac * leaf_volume;
+
+    double root_osmotic_potential = (-R * soil_temperature_avg * m_sucrose_root) / (root_storage_water * M_sucrose);  // MPa
+    double stem_osmotic_potential = (-R * leaf_temperature * m_sucrose_stem) / (stem_storage_water * M_sucrose);
+    double leaf_osmotic_potential = (-R * leaf_temperature * m_sucrose_leaf) / (leaf_storage_water * M_sucrose);
+
+    // Update the output quantity list
+    for (int l = 0; l < number_of_soil_layers; l++) {
+        update(soil_potential_op[l], total_potential[l]);
+        update(soil_pressure_potential_op[l], pressure_potential[l]);
+    }
+    update(soil_potential_avg_op, volumetric_avg);
+    update(soil_pressure_potential_avg_op, volumetric_pressure_avg);
+
+    update(root_osmotic_potential_op, root_osmotic_potential);
+    update(stem_osmotic_potential_op, stem_osmotic_potential);
+    update(leaf_osmotic_potential_op, leaf_osmotic_potential);
+
+    // Total potential; see total_potential.h
+    update(root_total_potential_op, root_pressure_potential + root_osmotic_potential);
+    update(stem_total_potential_op, stem_pressure_potential + stem_osmotic_potential);
+    update(leaf_total_potential_op, leaf_pressure_potential + leaf_osmotic_potential);
+}
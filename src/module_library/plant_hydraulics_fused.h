@@ -0,0 +1,86 @@
+#ifndef BioCroWP_PLANT_HYDRAULICS_FUSED_H
+#define BioCroWP_PLANT_HYDRAULICS_FUSED_H
+
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+
+namespace BioCroWP
+{
+/**
+ * @class plant_hydraulics_fused
+ *
+ * @brief Evaluates the `soil_potential`, `osmotic_potential`, and
+ * `total_potential` direct modules in a single pass.
+ *
+ * In the modular chain, the osmotic potentials are written to the shared
+ * quantity map by `osmotic_potential` and then read back by `total_potential`.
+ * Here they are kept as local values and only published once, so the chain
+ * costs one module call instead of three. The equations and the order of
+ * floating-point operations are identical to those of the individual modules,
+ * and all of their outputs are still produced, so this module can replace the
+ * three of them in a direct module list without changing any results.
+ *
+ * The `pressure_potential` module calculates derivatives and therefore cannot
+ * be merged into a direct module; it should still be included in the list of
+ * differential modules, where it reads the total potentials produced here.
+ */
+class plant_hydraulics_fused : public direct_module
+{
+   public:
+    plant_hydraulics_fused(
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs();
+    static string_vector get_outputs();
+    static std::string get_name() { return "plant_hydraulics_fused"; }
+
+   private:
+    // References to input quantities used by the soil potential calculation
+    double const& max_rooting_layer;
+
+    std::vector<const double*> soil_n_ip;             // dimensionless
+    std::vector<const double*> soil_m_ip;             // dimensionless
+    std::vector<const double*> soil_alpha_ip;         // cm-1
+    std::vector<const double*> soil_residual_wc_ip;   // dimensionless
+    std::vector<const double*> soil_saturated_wc_ip;  // dimensionless
+    std::vector<const double*> soil_depth_ip;         // cm
+    std::vector<const double*> soil_water_content_ip; // cm3 [water] / cm3 [soil]
+
+    // References to input quantities used by the osmotic potential calculation
+    double const& leaf_temperature;
+    double const& soil_temperature_avg;
+
+    double const& root_volume;
+    double const& stem_volume;
+    double const& leaf_volume;
+
+    double const& storage_water_frac;
+
+    // References to input quantities used by the total potential calculation
+    double const& root_pressure_potential;
+    double const& stem_pressure_potential;
+    double const& leaf_pressure_potential;
+
+    // Pointers to output quantities
+    std::vector<double*> soil_potential_op;
+    double* soil_potential_avg_op;
+
+    std::vector<double*> soil_pressure_potential_op;
+    double* soil_pressure_potential_avg_op;
+
+    double* root_osmotic_potential_op;
+    double* stem_osmotic_potential_op;
+    double* leaf_osmotic_potential_op;
+
+    double* root_total_potential_op;
+    double* stem_total_potential_op;
+    double* leaf_total_potential_op;
+
+    // Main operation
+    void do_operation() const;
+};
+
+}  // namespace BioCroWP
+#endif
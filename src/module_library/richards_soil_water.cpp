@@ -0,0 +1,389 @@
+#include <algorithm>  // for std::min, std::max, std::swap
+#include <cmath>      // for std::abs, std::isfinite
+#include <stdexcept>  // for std::runtime_error
+#include "../framework/module_helper_functions.h"  // for get_op, get_multilayer_ip, get_multilayer_op
+#include "van_genuchten.h"
+#include "richards_soil_water.h"
+
+using BioCroWP::richards_soil_water;
+namespace vg = BioCroWP::van_genuchten;
+
+namespace
+{
+// Solver settings; the step length adjustments follow Simunek et al. (2005)
+int const max_iterations = 10;
+int const max_halvings = 10;
+int const max_substeps = 1024;
+double const head_tolerance = 1e-6;            // relative to 1 cm + |head|
+double const water_content_tolerance = 1e-9;  // dimensionless
+int const fast_iterations = 3;
+int const slow_iterations = 7;
+double const growth_factor = 1.3;
+double const reduction_factor = 0.7;
+double const failure_factor = 1.0 / 3.0;
+
+// Within this distance of saturation the relative conductivity is smoothed
+double const smoothing_band = 0.1;  // cm
+
+// The surface cannot be drier than this pressure head, which limits the
+// evaporation rate, as with the minimum surface pressure head of HYDRUS
+double const minimum_surface_head = -1e5;  // cm
+
+// Saturated layers store a little more water as their pressure head rises
+// above zero, so that the heads in a saturated part of the profile are well
+// defined
+double const specific_storage = 1e-7;  // cm-1
+
+string_vector const layer_quantities = {
+    "soil_water_content",           // dimensionless
+    "soil_depth",                   // cm
+    "soil_alpha",                   // cm-1
+    "soil_n",                       // dimensionless
+    "soil_m",                       // dimensionless
+    "soil_residual_wc",             // dimensionless
+    "soil_saturated_wc",            // dimensionless
+    "soil_saturated_conductivity"   // cm / hr
+};
+}  // namespace
+
+richards_soil_water::richards_soil_water(
+    int nlayers,
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : differential_module(true),
+
+      // Store the number of layers
+      nlayers{nlayers},
+
+      // Get references to input quantities
+      timestep{get_input(input_quantities, "timestep")},
+      soil_surface_flux{get_input(input_quantities, "soil_surface_flux")},
+
+      soil_water_content_ip{get_multilayer_ip(input_quantities, nlayers, "soil_water_content")},
+      soil_depth_ip{get_multilayer_ip(input_quantities, nlayers, "soil_depth")},
+      soil_alpha_ip{get_multilayer_ip(input_quantities, nlayers, "soil_alpha")},
+      soil_n_ip{get_multilayer_ip(input_quantities, nlayers, "soil_n")},
+      soil_m_ip{get_multilayer_ip(input_quantities, nlayers, "soil_m")},
+      soil_residual_wc_ip{get_multilayer_ip(input_quantities, nlayers, "soil_residual_wc")},
+      soil_saturated_wc_ip{get_multilayer_ip(input_quantities, nlayers, "soil_saturated_wc")},
+      soil_saturated_conductivity_ip{get_multilayer_ip(input_quantities, nlayers, "soil_saturated_conductivity")},
+
+      // Allocate storage for intermediate values
+      initial_water_content(nlayers),
+      water_content(nlayers),
+      head(nlayers),
+      iterate_water_content(nlayers),
+      capacity(nlayers),
+      conductivity(nlayers),
+      conductivity_derivative(nlayers),
+      residual(nlayers),
+      newton_step(nlayers),
+      trial_head(nlayers),
+      system(nlayers),
+
+      // Get pointers to output quantities
+      soil_surface_runoff_op{get_op(output_quantities, "soil_surface_runoff")},
+      soil_evaporation_deficit_op{get_op(output_quantities, "soil_evaporation_deficit")},
+      soil_water_content_op{get_multilayer_op(output_quantities, nlayers, "soil_water_content")}
+{
+}
+
+string_vector richards_soil_water::get_inputs(int nlayers)
+{
+    string_vector inputs = {
+        "timestep",          // hr
+        "soil_surface_flux"  // cm / hr
+    };
+
+    string_vector const layers = generate_multilayer_quantity_names(nlayers, layer_quantities);
+    inputs.insert(inputs.end(), layers.begin(), layers.end());
+
+    return inputs;
+}
+
+string_vector richards_soil_water::get_outputs(int nlayers)
+{
+    string_vector outputs = {
+        "soil_surface_runoff",      // cm / hr
+        "soil_evaporation_deficit"  // cm / hr
+    };
+
+    string_vector const layers = generate_multilayer_quantity_names(nlayers, {"soil_water_content"});  // hr-1
+    outputs.insert(outputs.end(), layers.begin(), layers.end());
+
+    return outputs;
+}
+
+void richards_soil_water::do_operation() const
+{
+    double const dt = timestep;  // hr
+
+    for (int i = 0; i < nlayers; ++i) {
+        initial_water_content[i] = *soil_water_content_ip[i];
+    }
+
+    water_content = initial_water_content;
+
+    // Advance through the timestep with implicit steps whose length adapts to
+    // the number of iterations they need. Every call starts with a single step
+    // spanning the whole timestep, so the result only depends on the inputs.
+    double runoff = 0.0;               // cm
+    double evaporation_deficit = 0.0;  // cm
+    double step_length = dt;           // hr
+    double remaining = dt;
+    while (remaining > 0) {
+        double const length = std::max(step_length, dt / max_substeps);
+        double const step = std::min(length, remaining);
+
+        double infiltration;  // cm / hr
+        int const iterations = implicit_step(step, infiltration);
+
+        if (iterations < 0) {
+            if (step <= dt / max_substeps) {
+                throw std::runtime_error(
+                    "Thrown by richards_soil_water: the Newton iteration did not "
+                    "converge with the shortest allowed step length");
+            }
+            step_length = step * failure_factor;
+            continue;
+        }
+
+        if (soil_surface_flux > 0) {
+            runoff += (soil_surface_flux - infiltration) * step;
+        } else {
+            evaporation_deficit += (infiltration - soil_surface_flux) * step;
+        }
+        remaining = step < remaining ? remaining - step : 0;
+
+        // A step shortened to finish the timestep does not shorten the next one
+        double const factor = iterations <= fast_iterations  ? growth_factor
+                              : iterations >= slow_iterations ? reduction_factor
+                                                              : 1.0;
+        step_length = std::min(step < length ? std::max(length, step * factor) : step * factor, dt);
+    }
+
+    // Update the output quantity list
+    update(soil_surface_runoff_op, dt > 0 ? runoff / dt : 0.0);
+    update(soil_evaporation_deficit_op, dt > 0 ? evaporation_deficit / dt : 0.0);
+
+    for (int i = 0; i < nlayers; ++i) {
+        update(soil_water_content_op[i], dt > 0 ? (water_content[i] - initial_water_content[i]) / dt : 0.0);
+    }
+}
+
+/**
+ *  @brief Advances `water_content` by one backward Euler step of length `dt`
+ *  and returns the number of Newton iterations that were needed.
+ *
+ *  `infiltration` is set to the rate at which water entered the top layer
+ *  during the step, which is less than the surface flux when the surface is
+ *  ponded and greater than it when evaporation is limited. If the iteration
+ *  does not converge, `water_content` is left unchanged and -1 is returned.
+ */
+int richards_soil_water::implicit_step(double dt, double& infiltration) const
+{
+    for (int i = 0; i < nlayers; ++i) {
+        double const excess = water_content[i] - *soil_saturated_wc_ip[i];
+        if (excess > 0) {
+            head[i] = excess / specific_storage;
+        } else {
+            head[i] = vg::head(
+                vg::effective_saturation(water_content[i], *soil_residual_wc_ip[i], *soil_saturated_wc_ip[i]),
+                *soil_alpha_ip[i], *soil_n_ip[i], *soil_m_ip[i]);
+        }
+    }
+
+    double norm = evaluate_residual(head, dt, infiltration);
+
+    // The full Newton step can overshoot badly near saturation, where the
+    // capacity and conductivity change rapidly, so the step is halved until
+    // the residual decreases
+    bool converged = false;
+    int iteration = 0;
+    while (iteration < max_iterations && !converged) {
+        ++iteration;
+
+        for (int i = 0; i < nlayers; ++i) {
+            newton_step[i] = -residual[i];
+        }
+
+        system.factorize();
+        system.solve(newton_step);
+
+        double change = 0.0;
+        for (int i = 0; i < nlayers; ++i) {
+            change = std::max(change, std::abs(newton_step[i]) / (1.0 + std::abs(head[i])));
+        }
+        converged = change <= head_tolerance;
+
+        double fraction = 1.0;
+        for (int halving = 0;; ++halving) {
+            for (int i = 0; i < nlayers; ++i) {
+                trial_head[i] = head[i] + fraction * newton_step[i];
+            }
+
+            double const trial_norm = evaluate_residual(trial_head, dt, infiltration);
+
+            if (converged || halving == max_halvings ||
+                trial_norm <= (1.0 - 1e-4 * fraction) * norm) {
+                norm = trial_norm;
+                break;
+            }
+
+            fraction *= 0.5;
+        }
+
+        std::swap(head, trial_head);
+
+        // The properties of very dry layers can overflow
+        if (!std::isfinite(norm)) {
+            return -1;
+        }
+
+        // The heads in nearly saturated layers may still be changing after
+        // the water balance of every layer is met
+        double imbalance = 0.0;
+        for (int i = 0; i < nlayers; ++i) {
+            imbalance = std::max(imbalance, std::abs(residual[i]) * dt / *soil_depth_ip[i]);
+        }
+        converged = converged || imbalance <= water_content_tolerance;
+    }
+
+    if (!converged) {
+        return -1;
+    }
+
+    water_content = iterate_water_content;
+
+    return iteration;
+}
+
+/**
+ *  @brief Calculates the water balance residual of each layer (cm / hr) for
+ *  the pressure heads `h` and returns the sum of their squares.
+ *
+ *  The layer water contents, capacities, and conductivities at `h` are stored,
+ *  the Jacobian of the residuals with respect to `h` is stored in `system`,
+ *  and `infiltration` is set to the flow through the surface.
+ */
+double richards_soil_water::evaluate_residual(
+    std::vector<double> const& h,
+    double dt,
+    double& infiltration) const
+{
+    for (int i = 0; i < nlayers; ++i) {
+        double const range = *soil_saturated_wc_ip[i] - *soil_residual_wc_ip[i];
+        double const Ks = *soil_saturated_conductivity_ip[i];
+
+        double Se;
+        double dSe;
+        double Kr;
+        double dKr;
+        vg::hydraulic_properties(h[i], *soil_alpha_ip[i], *soil_n_ip[i], *soil_m_ip[i], Se, dSe, Kr, dKr);
+
+        // When n is below 2, the slope of the relative conductivity grows
+        // without bound near saturation, and the Newton iteration cannot
+        // settle on heads close to zero. Within the smoothing band it is
+        // replaced by a cubic that matches its value and slope at the edge of
+        // the band and reaches 1 with zero slope at saturation.
+        if (h[i] < 0 && h[i] > -smoothing_band) {
+            double Se_edge;
+            double dSe_edge;
+            double Kr_edge;
+            double dKr_edge;
+            vg::hydraulic_properties(-smoothing_band, *soil_alpha_ip[i], *soil_n_ip[i], *soil_m_ip[i], Se_edge, dSe_edge, Kr_edge, dKr_edge);
+
+            double const t = 1.0 + h[i] / smoothing_band;
+            double const slope = dKr_edge * smoothing_band;
+            Kr = Kr_edge + slope * t * (1.0 - t) * (1.0 - t) +
+                 (1.0 - Kr_edge) * t * t * (3.0 - 2.0 * t);
+            dKr = (slope * (1.0 - t) * (1.0 - 3.0 * t) +
+                   (1.0 - Kr_edge) * 6.0 * t * (1.0 - t)) /
+                  smoothing_band;
+        }
+
+        iterate_water_content[i] = *soil_residual_wc_ip[i] + range * Se;
+        capacity[i] = range * dSe;
+        conductivity[i] = Ks * Kr;
+        conductivity_derivative[i] = Ks * dKr;
+
+        if (h[i] > 0) {
+            iterate_water_content[i] += specific_storage * h[i];
+            capacity[i] = specific_storage;
+        }
+    }
+
+    // Each residual is the storage change of one layer minus its net inflow.
+    // Flows between layers use the arithmetic mean of the layer
+    // conductivities, and the downward flow through the bottom of the profile
+    // is the conductivity of the bottom layer.
+    //
+    // The surface is ponded when the flux exceeds the rate at which the top
+    // layer can absorb water with a pressure head of zero at the surface; the
+    // surface head is then held at zero and the excess runs off. Likewise,
+    // evaporation is limited to the rate at which the top layer can supply
+    // water with the minimum pressure head at the surface, and it stops if the
+    // top layer is even drier. As between layers, the flow through the surface
+    // uses the mean of the conductivities on either side, where the surface
+    // has the conductivity of the top layer at the surface head.
+    bool const wetting = soil_surface_flux > 0;
+    double const surface_head = wetting ? 0.0 : minimum_surface_head;  // cm
+    double surface_conductivity = *soil_saturated_conductivity_ip[0];  // cm / hr
+    if (!wetting) {
+        double Se;
+        double dSe;
+        double Kr;
+        double dKr;
+        vg::hydraulic_properties(surface_head, *soil_alpha_ip[0], *soil_n_ip[0], *soil_m_ip[0], Se, dSe, Kr, dKr);
+        surface_conductivity *= Kr;
+    }
+
+    double norm = 0.0;
+    for (int i = 0; i < nlayers; ++i) {
+        double const dz = *soil_depth_ip[i];
+        double r = dz / dt * (iterate_water_content[i] - water_content[i]);
+        double diagonal = dz / dt * capacity[i];
+
+        if (i == 0) {
+            double const K = 0.5 * (surface_conductivity + conductivity[0]);
+            double const g = 1.0 / (0.5 * dz);
+            double const gradient = (surface_head - h[0]) * g + 1.0;
+            double const limit = K * gradient;
+
+            if (!(wetting ? soil_surface_flux > limit : soil_surface_flux < limit)) {
+                infiltration = soil_surface_flux;
+            } else if (wetting || limit < 0) {
+                infiltration = limit;
+                diagonal -= 0.5 * conductivity_derivative[0] * gradient - K * g;
+            } else {
+                infiltration = 0.0;
+            }
+            r -= infiltration;
+        } else {
+            double const K = 0.5 * (conductivity[i - 1] + conductivity[i]);
+            double const g = 1.0 / (0.5 * (*soil_depth_ip[i - 1] + dz));
+            double const gradient = (h[i - 1] - h[i]) * g + 1.0;
+            r -= K * gradient;
+            system.lower[i] = -(0.5 * conductivity_derivative[i - 1] * gradient + K * g);
+            diagonal -= 0.5 * conductivity_derivative[i] * gradient - K * g;
+        }
+
+        if (i == nlayers - 1) {
+            r += conductivity[i];
+            diagonal += conductivity_derivative[i];
+        } else {
+            double const K = 0.5 * (conductivity[i] + conductivity[i + 1]);
+            double const g = 1.0 / (0.5 * (dz + *soil_depth_ip[i + 1]));
+            double const gradient = (h[i] - h[i + 1]) * g + 1.0;
+            r += K * gradient;
+            system.upper[i] = 0.5 * conductivity_derivative[i + 1] * gradient - K * g;
+            diagonal += 0.5 * conductivity_derivative[i] * gradient + K * g;
+        }
+
+        residual[i] = r;
+        system.diagonal[i] = diagonal;
+        norm += r * r;
+    }
+
+    return norm;
+}
@@ -0,0 +1,195 @@
+#ifndef BioCroWP_RICHARDS_SOIL_WATER_H
+#define BioCroWP_RICHARDS_SOIL_WATER_H
+
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+#include "tridiagonal_system.h"
+
+namespace BioCroWP
+{
+/**
+ * @class richards_soil_water
+ *
+ * @brief Calculates the change in soil water content of `nlayers` soil layers
+ * from the one-dimensional Richards equation.
+ *
+ * Layers are numbered from 0 at the surface using the multilayer naming
+ * convention; e.g., `soil_water_content_layer_00` is the top layer of a
+ * fifty-layer profile. Each layer has its own thickness `soil_depth` (cm) and
+ * van Genuchten parameters `soil_alpha` (cm-1), `soil_n`, `soil_m`,
+ * `soil_residual_wc`, and `soil_saturated_wc`, as in `soil_potential`, along
+ * with a saturated hydraulic conductivity `soil_saturated_conductivity`
+ * (cm / hr) that is scaled by the Mualem relative conductivity. Water enters
+ * the top of the profile at the rate `soil_surface_flux` (cm / hr), which is
+ * negative for evaporation, and drains freely from the bottom under a unit
+ * hydraulic gradient. When the flux is greater than the top layer can absorb
+ * with a pressure head of zero at the surface, the surface is ponded: the
+ * surface head is held at zero, and the water that cannot enter runs off.
+ * The runoff rate is reported as `soil_surface_runoff` (cm / hr), the
+ * derivative of a cumulative runoff depth. Similarly, evaporation cannot dry
+ * the surface below a pressure head of -1e5 cm, so when the top layer cannot
+ * supply the evaporation rate, the surface head is held there, and the part
+ * of the demand that is not met is reported as `soil_evaporation_deficit`
+ * (cm / hr). If the top layer is already drier than that, no water
+ * evaporates.
+ *
+ * Explicit integration of many thin layers is very stiff, so this module
+ * instead advances the water contents over one `timestep` with the implicit
+ * (backward Euler) mixed form of the Richards equation (Celia et al., 1990),
+ * which conserves water. The nonlinear equations are solved by Newton's method
+ * with a backtracking line search; each iteration solves a tridiagonal system
+ * for the layer pressure heads with the Thomas algorithm, so the cost of one
+ * iteration is proportional to the number of layers. When `soil_n` is below 2,
+ * the slope of the Mualem conductivity grows without bound near saturation
+ * (Ippisch et al., 2006), so within 0.1 cm of saturation the relative
+ * conductivity is replaced by a smooth curve that rises to 1. Saturated layers
+ * hold a little more water as their pressure head rises, with a specific
+ * storage of 1e-7 cm-1, so their water contents can slightly exceed
+ * `soil_saturated_wc`.
+ *
+ * When the soil is wetting quickly, the timestep is divided into shorter
+ * implicit steps whose length is adjusted according to the number of
+ * iterations they need, as in HYDRUS (Simunek et al., 2005). Each call starts
+ * with a single step spanning the whole timestep, so the outputs only depend
+ * on the inputs. The output is the average rate of change over the timestep,
+ * so this module requires the Euler ODE solver. An exception is thrown if an
+ * implicit step does not converge even when the timestep has been divided
+ * into the largest allowed number of steps.
+ *
+ * Thinner layers resolve a wetting front more sharply, so more and shorter
+ * steps are needed to follow it; the total cost therefore grows faster than
+ * the number of layers. For infiltration into a dry loam, one hour takes about
+ * 55 microseconds with 50 layers and 2 to 3 milliseconds with 800 layers (see
+ * `benchmarks/richards_soil_water.cpp`), whereas a profile that is only
+ * draining needs a single step.
+ *
+ * Other differential modules, such as a root water uptake model, can add their
+ * own contributions to the same derivatives.
+ *
+ * The layer water potentials can be calculated from the water contents by the
+ * corresponding `layered_soil_potential` module. Modules for particular
+ * numbers of layers are derived from this class; see
+ * `fifty_layer_richards_soil_water` for an example.
+ */
+class richards_soil_water : public differential_module
+{
+   public:
+    richards_soil_water(
+        int nlayers,
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs(int nlayers);
+    static string_vector get_outputs(int nlayers);
+
+   private:
+    // Number of layers
+    int const nlayers;
+
+    // References to input quantities
+    double const& timestep;
+    double const& soil_surface_flux;
+
+    std::vector<const double*> soil_water_content_ip;           // dimensionless
+    std::vector<const double*> soil_depth_ip;                   // cm
+    std::vector<const double*> soil_alpha_ip;                   // cm-1
+    std::vector<const double*> soil_n_ip;                       // dimensionless
+    std::vector<const double*> soil_m_ip;                       // dimensionless
+    std::vector<const double*> soil_residual_wc_ip;             // dimensionless
+    std::vector<const double*> soil_saturated_wc_ip;            // dimensionless
+    std::vector<const double*> soil_saturated_conductivity_ip;  // cm / hr
+
+    // Storage for intermediate values, allocated once
+    mutable std::vector<double> initial_water_content;    // dimensionless
+    mutable std::vector<double> water_content;            // dimensionless
+    mutable std::vector<double> head;                     // cm
+    mutable std::vector<double> iterate_water_content;    // dimensionless
+    mutable std::vector<double> capacity;                 // cm-1
+    mutable std::vector<double> conductivity;             // cm / hr
+    mutable std::vector<double> conductivity_derivative;  // hr-1
+    mutable std::vector<double> residual;                 // cm / hr
+    mutable std::vector<double> newton_step;              // cm
+    mutable std::vector<double> trial_head;               // cm
+    mutable tridiagonal_system system;
+
+    // Pointers to output quantities
+    double* soil_surface_runoff_op;              // cm / hr
+    double* soil_evaporation_deficit_op;         // cm / hr
+    std::vector<double*> soil_water_content_op;  // hr-1
+
+    // Main operation
+    void do_operation() const;
+
+    int implicit_step(double dt, double& infiltration) const;
+    double evaluate_residual(std::vector<double> const& h, double dt, double& infiltration) const;
+};
+
+/**
+ * @class fifty_layer_richards_soil_water
+ *
+ * @brief A `richards_soil_water` module with fifty soil layers.
+ */
+class fifty_layer_richards_soil_water : public richards_soil_water
+{
+   public:
+    fifty_layer_richards_soil_water(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : richards_soil_water(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return richards_soil_water::get_inputs(nlayers); }
+    static string_vector get_outputs() { return richards_soil_water::get_outputs(nlayers); }
+    static std::string get_name() { return "fifty_layer_richards_soil_water"; }
+
+   private:
+    static int const nlayers = 50;
+};
+
+/**
+ * @class hundred_layer_richards_soil_water
+ *
+ * @brief A `richards_soil_water` module with one hundred soil layers.
+ */
+class hundred_layer_richards_soil_water : public richards_soil_water
+{
+   public:
+    hundred_layer_richards_soil_water(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : richards_soil_water(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return richards_soil_water::get_inputs(nlayers); }
+    static string_vector get_outputs() { return richards_soil_water::get_outputs(nlayers); }
+    static std::string get_name() { return "hundred_layer_richards_soil_water"; }
+
+   private:
+    static int const nlayers = 100;
+};
+
+/**
+ * @class two_hundred_layer_richards_soil_water
+ *
+ * @brief A `richards_soil_water` module with two hundred soil layers.
+ */
+class two_hundred_layer_richards_soil_water : public richards_soil_water
+{
+   public:
+    two_hundred_layer_richards_soil_water(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : richards_soil_water(nlayers, input_quantities, output_quantities)
+    {
+    }
+    static string_vector get_inputs() { return richards_soil_water::get_inputs(nlayers); }
+    static string_vector get_outputs() { return richards_soil_water::get_outputs(nlayers); }
+    static std::string get_name() { return "two_hundred_layer_richards_soil_water"; }
+
+   private:
+    static int const nlayers = 200;
+};
+
+}  // namespace BioCroWP
+#endif
@@ -199,8 +199,8 @@ void soil_potential::do_operation() const
   }
 
   // calculate average matric potential value for entire root zone
-  double num;
-  double denom;
+  double num = 0.0;
+  double denom = 0.0;
   for(int l = 0; l < max_rooting_layer; l++){
     num += soil_wc[l]*soil_depth[l]*total_potential[l];
     denom += soil_wc[l]*soil_depth[l];
@@ -209,8 +209,8 @@ void soil_potential::do_operation() const
   double volumetric_avg = num/denom;
 
   // repeating for pressure potential
-  double num_p;
-  double denom_p;
+  double num_p = 0.0;
+  double denom_p = 0.0;
   for(int l = 0; l < max_rooting_layer; l++){
     num_p += soil_wc[l]*soil_depth[l]*total_potential[l];
     denom_p += soil_wc[l]*soil_depth[l];
@@ -175,6 +175,10 @@ class soil_potential : public direct_module
     // main operation
     void do_operation() const;
 
+    // Lets a static_module_pipeline call do_operation() without virtual dispatch
+    template <typename... Modules>
+    friend class static_module_pipeline;
+
 };
 
 } // end of namespace
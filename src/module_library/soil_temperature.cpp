@@ -1,11 +1,15 @@
 #include "soil_temperature.h"
+#include "soil_thermal_properties.h"  // for soil_thermal_conductivity, soil_heat_capacity
 #include <cmath>
-#include <vector>
+#include <stdexcept>  // for std::out_of_range
+#include <string>     // for std::to_string
 
 // sinusoidal function to estimate hourly soil temperature fluctuations
 // Hillel, 1982; Marshall and Holmes, 1988; Wu and Nofziger, 1999
 
 using BioCroWP::soil_temperature;
+using BioCroWP::soil_thermal_conductivity;
+using BioCroWP::soil_heat_capacity;
 
 string_vector soil_temperature::get_inputs()
 {
@@ -70,6 +74,14 @@ string_vector soil_temperature::get_outputs()
 
 void soil_temperature::do_operation() const
 {
+    // The layer arrays below have six elements, and at least one layer is
+    // needed to calculate the average temperature
+    if (max_rooting_layer < 1 || max_rooting_layer > 6) {
+        throw std::out_of_range(
+            "Thrown by soil_temperature: max_rooting_layer must be between 1 "
+            "and 6, but its value is " + std::to_string(max_rooting_layer));
+    }
+
     double pi = 3.14159265358979323846;
 
     double sd_arr[] = {
@@ -122,79 +134,33 @@ void soil_temperature::do_operation() const
         tot_soil_depth += sd_arr[l]; // m
     }
 
-    // Degree of saturation calculated via definitions of porosity and volumetric swc
-    std::vector<double> s_r_arr;
-    for(int l = 0; l < max_rooting_layer; l++){
-        s_r_arr.push_back(swc_arr[l]/soil_sat_capacity_arr[l]); // dimensionless
-    }
-
     // fudge by 0.5 degrees celcius is recommended because air temp is used instead of soil surface temp (Moore et al. (2020))
     double min_K = minimum_temp_day + 273.15 + 0.5; // K
     double max_K = maximum_temp_day + 273.15 + 0.5;
 
-    // Thermal conductivity of water
-    double k_w = 51.41/24; // kJ m-1 hr-1 K-1
-
-    // soil particle thermal conductivity from Gemant (1950)
-    std::vector<double> k_s_arr;
-    for(int l = 0; l < max_rooting_layer; l++){
-        k_s_arr.push_back((504.58 - 2.85*clay_content_arr[l])/24); // kJ m-1 hr-1 K-1
-    } 
-
     // thermal conductivity model is from Cote and Konrad (2005)
-    // saturated soil thermal conductivity
-    std::vector<double> k_sat_arr;
-    for(int l = 0; l < max_rooting_layer; l++){
-        k_sat_arr.push_back(pow(k_s_arr[l], (1 - soil_sat_capacity_arr[l]))*pow(k_w, soil_sat_capacity_arr[l])); // kJ m-1 d-1 K-1
-    }
-    
-    // dry soil thermal conductivity
-    // X = 0.75 (W/m*deg C) and n = 1.2 (dimensionless) for natural mineral soils
-    // W/(m*deg C) = (J/(m*s*deg C))
-    // 1 J/(m*s*deg C)(1 kJ/1000 J)(3600 s/1 hr)(1 deg C/ 1 deg K) = 3.6 kJ m-1 hr-1 K-1
-    std::vector<double> k_dry_arr;
-    for(int l = 0; l < max_rooting_layer; l++){
-        k_dry_arr.push_back((0.75*3.6)*pow(10, (-1.2*soil_sat_capacity_arr[l]))); // kJ m-1 hr-1 K-1
-    }
-
-    // determining k parameter for each soil layer
-    std::vector<double> k_arr; // empty k vector
-    for (int l = 0; l < max_rooting_layer; l++){
-        if (soil_type_indicator_arr[l] == 1 || soil_type_indicator_arr[l] == 2 || soil_type_indicator_arr[l] == 3) {
-            k_arr.push_back(3.55); // medium or fine sand
-        } else {
-            k_arr.push_back(1.90); // silty or clayey soil
-    }
-    }
-    
-    // normalized thermal conductivity
-    std::vector<double> k_r_arr;
-    for (int l = 0; l < max_rooting_layer; l++){
-       k_r_arr.push_back((k_arr[l]*s_r_arr[l])/(1 + (k_arr[l] - 1)*s_r_arr[l])); // Unitless
-    } 
-
-    std::vector<double> k_tot_arr;
+    double k_tot_arr[6] = {0};
     for (int l = 0; l < max_rooting_layer; l++){
-       k_tot_arr.push_back((k_sat_arr[l] - k_dry_arr[l])*k_r_arr[l] + k_dry_arr[l]);  // kJ m-1 hr-1 K-1
+       k_tot_arr[l] = soil_thermal_conductivity(swc_arr[l], soil_sat_capacity_arr[l], clay_content_arr[l], soil_type_indicator_arr[l]);  // kJ m-1 hr-1 K-1
     }
 
     // Hillel, D. 1982. Introduction to soil physics. Academic Press, San Diego, CA.
-    std::vector<double> heat_cap_arr;
+    double heat_cap_arr[6] = {0};
     for (int l = 0; l < max_rooting_layer; l++){
-       heat_cap_arr.push_back(2000*(1 - soil_sat_capacity_arr[l]) + 4200*swc_arr[l]); // kJ m-3 K-1
+       heat_cap_arr[l] = soil_heat_capacity(swc_arr[l], soil_sat_capacity_arr[l]); // kJ m-3 K-1
     }
 
     // sinusoidal function for hourly soil temperature variation
     double w = (pi*2)/24; // frequency (1/hr)
-    std::vector<double> d_arr;
+    double d_arr[6] = {0};
     for (int l = 0; l < max_rooting_layer; l++){
-       d_arr.push_back(pow(((2*k_tot_arr[l])/(heat_cap_arr[l]*w)), 0.5)); // m
+       d_arr[l] = pow(((2*k_tot_arr[l])/(heat_cap_arr[l]*w)), 0.5); // m
     }
 
     // amplitude at a given depth (hr)
-    std::vector<double> a_z_arr;
+    double a_z_arr[6] = {0};
     for(int l = 0; l < max_rooting_layer; l++){
-        a_z_arr.push_back(((max_K - min_K)/2)*exp(-sd_arr[l]/d_arr[l])); // K
+        a_z_arr[l] = ((max_K - min_K)/2)*exp(-sd_arr[l]/d_arr[l]); // K
     }
 
     // average daily soil surface temp
@@ -203,21 +169,21 @@ void soil_temperature::do_operation() const
     // lag time (hrs) calculation for each soil layer
     // the amount of time it takes for a temperature fluctuation to travel from the surface to a given depth
     // lag time = (24hrs/2*pi) x (z/d), from Chu
-    std::vector<double> lag_time_arr;
+    double lag_time_arr[6] = {0};
     for(int l = 0; l < max_rooting_layer; l++){
-        lag_time_arr.push_back((24/(2*pi))*(sd_arr[l]/d_arr[l])); // hr
+        lag_time_arr[l] = (24/(2*pi))*(sd_arr[l]/d_arr[l]); // hr
     }
 
     // phase constant aligns the temperature minimum to the actual observed minimum
-    std::vector<double> phase_arr;
+    double phase_arr[6] = {0};
     for(int l = 0; l < max_rooting_layer; l++){
-        phase_arr.push_back((pi/2) + w*lag_time_arr[l]); // dimensionless
+        phase_arr[l] = (pi/2) + w*lag_time_arr[l]; // dimensionless
     }
 
     // soil temperature at each soil layer
-    std::vector<double> soil_temperature_arr;
+    double soil_temperature_arr[6] = {0};
     for(int l = 0; l < max_rooting_layer; l++){
-        soil_temperature_arr.push_back(T_a + a_z_arr[l]*sin(w*hour - (sd_arr[l]/d_arr[l]) - phase_arr[l]));
+        soil_temperature_arr[l] = T_a + a_z_arr[l]*sin(w*hour - (sd_arr[l]/d_arr[l]) - phase_arr[l]);
     }
 
     // averaging soil temp
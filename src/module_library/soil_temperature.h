@@ -128,6 +128,10 @@ class soil_temperature : public direct_module
 
     // Main operation
     void do_operation() const;
+
+    // Lets a static_module_pipeline call do_operation() without virtual dispatch
+    template <typename... Modules>
+    friend class static_module_pipeline;
 };
 
 }  // namespace BioCroWP
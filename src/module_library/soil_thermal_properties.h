@@ -0,0 +1,61 @@
+#ifndef BioCroWP_SOIL_THERMAL_PROPERTIES_H
+#define BioCroWP_SOIL_THERMAL_PROPERTIES_H
+
+#include <cmath>  // for pow
+
+namespace BioCroWP
+{
+/**
+ *  @brief The thermal conductivity of a soil layer (kJ m-1 hr-1 K-1) from the
+ *  model of Cote and Konrad (2005).
+ *
+ *  `soil_saturation_capacity` is the porosity, `soil_clay_content` is in
+ *  percent by volume, and a `soil_type_indicator` of 1, 2, or 3 denotes a
+ *  medium or fine sand rather than a silty or clayey soil.
+ */
+inline double soil_thermal_conductivity(
+    double soil_water_content,
+    double soil_saturation_capacity,
+    double soil_clay_content,
+    double soil_type_indicator)
+{
+    // Degree of saturation calculated via definitions of porosity and volumetric swc
+    double s_r = soil_water_content / soil_saturation_capacity;  // dimensionless
+
+    // Thermal conductivity of water
+    double k_w = 51.41 / 24;  // kJ m-1 hr-1 K-1
+
+    // soil particle thermal conductivity from Gemant (1950)
+    double k_s = (504.58 - 2.85 * soil_clay_content) / 24;  // kJ m-1 hr-1 K-1
+
+    // saturated soil thermal conductivity
+    double k_sat = pow(k_s, (1 - soil_saturation_capacity)) * pow(k_w, soil_saturation_capacity);
+
+    // dry soil thermal conductivity
+    // X = 0.75 (W/m*deg C) and n = 1.2 (dimensionless) for natural mineral soils
+    // 1 J/(m*s*deg C)(1 kJ/1000 J)(3600 s/1 hr)(1 deg C/ 1 deg K) = 3.6 kJ m-1 hr-1 K-1
+    double k_dry = (0.75 * 3.6) * pow(10, (-1.2 * soil_saturation_capacity));  // kJ m-1 hr-1 K-1
+
+    double k = soil_type_indicator == 1 || soil_type_indicator == 2 || soil_type_indicator == 3
+                   ? 3.55   // medium or fine sand
+                   : 1.90;  // silty or clayey soil
+
+    // normalized thermal conductivity
+    double k_r = (k * s_r) / (1 + (k - 1) * s_r);  // Unitless
+
+    return (k_sat - k_dry) * k_r + k_dry;  // kJ m-1 hr-1 K-1
+}
+
+/**
+ *  @brief The volumetric heat capacity of a soil layer (kJ m-3 K-1) from
+ *  Hillel, D. 1982. Introduction to soil physics. Academic Press, San Diego, CA.
+ */
+inline double soil_heat_capacity(
+    double soil_water_content,
+    double soil_saturation_capacity)
+{
+    return 2000 * (1 - soil_saturation_capacity) + 4200 * soil_water_content;  // kJ m-3 K-1
+}
+
+}  // namespace BioCroWP
+#endif
@@ -0,0 +1,264 @@
+#ifndef BioCroWP_STATIC_MODULE_PIPELINE_H
+#define BioCroWP_STATIC_MODULE_PIPELINE_H
+
+#include <cstddef>      // for size_t
+#include <set>
+#include <stdexcept>    // for std::logic_error
+#include <tuple>
+#include <type_traits>  // for std::integral_constant
+#include <utility>      // for std::pair
+#include <vector>
+#include "../framework/module.h"
+#include "../framework/module_helper_functions.h"  // for get_ip and get_op
+#include "../framework/state_map.h"
+
+namespace BioCroWP
+{
+namespace pipeline_detail
+{
+using copy_list = std::vector<std::pair<const double*, double*>>;
+
+}  // namespace pipeline_detail
+
+/**
+ * @class static_module_pipeline
+ *
+ * @brief A direct module that runs a fixed sequence of direct modules, chosen
+ * at compile time.
+ *
+ * A `dynamical_system` stores its direct modules as a `module_vector` and runs
+ * each one through a virtual call on a separately allocated object. For a
+ * configuration that never changes, the same modules can instead be listed as
+ * template arguments to this class. The module objects are then stored inline
+ * in a `std::tuple`, and the whole sequence appears to the framework as a
+ * single module. The pipeline calls each member's `do_operation()` through its
+ * concrete type, so these calls are not dispatched through the vtable and can
+ * be inlined. Since `do_operation()` is private, each member class must grant
+ * access to the pipeline:
+ *
+ *     template <typename... Modules>
+ *     friend class static_module_pipeline;
+ *
+ * The template arguments must be direct modules listed in evaluation order,
+ * i.e., a module may only use outputs from modules that precede it. The
+ * inputs of the pipeline are the inputs of its members that are not
+ * calculated within the pipeline, and its outputs are the outputs of all of
+ * its members.
+ *
+ * Module inputs and outputs are `string_vector`s that are only built at run
+ * time, so the evaluation order cannot be checked when the template is
+ * instantiated. Instead, it is checked by `get_inputs()`, which throws a
+ * `std::logic_error` for a pipeline whose members are out of order. Such a
+ * pipeline therefore fails the first time it is described or constructed
+ * (for example, by `module_info()`), before any member runs.
+ *
+ * To register a pipeline, derive a class that provides `get_name()` and add
+ * it to the module library table like any other module:
+ *
+ *     class my_pipeline
+ *         : public static_module_pipeline<module_a, module_b, module_c>
+ *     {
+ *        public:
+ *         using static_module_pipeline::static_module_pipeline;
+ *         static std::string get_name() { return "my_pipeline"; }
+ *     };
+ *
+ * Within a `dynamical_system`, input and output quantities are stored in the
+ * same `state_map`, and the member modules are bound to it directly. When the
+ * maps are separate (as when a module is evaluated by itself), the pipeline
+ * keeps a private map holding its own inputs and intermediate values; the
+ * inputs are copied into it before the members run, and the outputs are copied
+ * out afterwards.
+ */
+template <typename... Modules>
+class static_module_pipeline : public direct_module
+{
+   public:
+    static_module_pipeline(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+        : direct_module(),
+          local_quantities{
+              &input_quantities == output_quantities
+                  ? state_map{}
+                  : make_local_quantities(input_quantities)},
+          modules{Modules(
+              member_inputs(input_quantities, output_quantities),
+              member_outputs(input_quantities, output_quantities))...},
+          input_copies{
+              &input_quantities == output_quantities
+                  ? pipeline_detail::copy_list{}
+                  : make_input_copies(input_quantities)},
+          output_copies{
+              &input_quantities == output_quantities
+                  ? pipeline_detail::copy_list{}
+                  : make_output_copies(output_quantities)}
+    {
+    }
+
+    static_module_pipeline(static_module_pipeline const&) = delete;
+    static_module_pipeline& operator=(static_module_pipeline const&) = delete;
+
+    static string_vector get_inputs();
+    static string_vector get_outputs();
+
+   private:
+    // Only used when the input and output maps are different objects
+    state_map local_quantities;
+
+    std::tuple<Modules...> modules;
+
+    pipeline_detail::copy_list input_copies;
+    pipeline_detail::copy_list output_copies;
+
+    state_map const& member_inputs(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+    {
+        return &input_quantities == output_quantities ? input_quantities : local_quantities;
+    }
+
+    state_map* member_outputs(
+        state_map const& input_quantities,
+        state_map* output_quantities)
+    {
+        return &input_quantities == output_quantities ? output_quantities : &local_quantities;
+    }
+
+    static state_map make_local_quantities(state_map const& input_quantities);
+    pipeline_detail::copy_list make_input_copies(state_map const& input_quantities);
+    pipeline_detail::copy_list make_output_copies(state_map* output_quantities);
+
+    // Runs the first `N` members, in order. The qualified call to
+    // `do_operation()` names the member's concrete type, so it is not a
+    // virtual call.
+    template <size_t N>
+    void run_members(std::integral_constant<size_t, N>) const
+    {
+        run_members(std::integral_constant<size_t, N - 1>{});
+
+        using member_type = typename std::tuple_element<N - 1, std::tuple<Modules...>>::type;
+        std::get<N - 1>(modules).member_type::do_operation();
+    }
+
+    void run_members(std::integral_constant<size_t, 0>) const {}
+
+    // Main operation
+    void do_operation() const;
+};
+
+/**
+ * @brief Returns the inputs of all member modules, excluding any quantities
+ * calculated by an earlier member.
+ *
+ * Also checks that the members are listed in a valid evaluation order and that
+ * no quantity is calculated by more than one member; these problems are
+ * reported by throwing a `std::logic_error`.
+ */
+template <typename... Modules>
+string_vector static_module_pipeline<Modules...>::get_inputs()
+{
+    string_vector const inputs_by_member[] = {Modules::get_inputs()...};
+    string_vector const outputs_by_member[] = {Modules::get_outputs()...};
+    string_vector const member_names = {Modules::get_name()...};
+    size_t const n = sizeof...(Modules);
+
+    string_set calculated;
+    string_set included;
+    string_vector inputs;
+
+    for (size_t i = 0; i < n; ++i) {
+        for (std::string const& name : inputs_by_member[i]) {
+            for (size_t j = i; j < n; ++j) {
+                for (std::string const& later_output : outputs_by_member[j]) {
+                    if (name == later_output) {
+                        throw std::logic_error(
+                            "Thrown by static_module_pipeline::get_inputs: '" +
+                            member_names[i] + "' uses '" + name +
+                            "', which is calculated by '" + member_names[j] +
+                            "'; the pipeline modules are not in evaluation order.");
+                    }
+                }
+            }
+
+            if (calculated.count(name) == 0 && included.insert(name).second) {
+                inputs.push_back(name);
+            }
+        }
+
+        for (std::string const& name : outputs_by_member[i]) {
+            if (!calculated.insert(name).second) {
+                throw std::logic_error(
+                    "Thrown by static_module_pipeline::get_inputs: '" + name +
+                    "' is calculated by more than one pipeline module.");
+            }
+        }
+    }
+
+    return inputs;
+}
+
+/**
+ * @brief Returns the outputs of all member modules, in order.
+ */
+template <typename... Modules>
+string_vector static_module_pipeline<Modules...>::get_outputs()
+{
+    string_vector const outputs_by_member[] = {Modules::get_outputs()...};
+
+    string_vector outputs;
+    for (string_vector const& sv : outputs_by_member) {
+        outputs.insert(outputs.end(), sv.begin(), sv.end());
+    }
+    return outputs;
+}
+
+template <typename... Modules>
+state_map static_module_pipeline<Modules...>::make_local_quantities(
+    state_map const& input_quantities)
+{
+    state_map local = input_quantities;
+    for (std::string const& name : get_outputs()) {
+        local[name] = 0.0;
+    }
+    return local;
+}
+
+template <typename... Modules>
+pipeline_detail::copy_list static_module_pipeline<Modules...>::make_input_copies(
+    state_map const& input_quantities)
+{
+    pipeline_detail::copy_list copies;
+    for (std::string const& name : get_inputs()) {
+        copies.push_back({get_ip(input_quantities, name), &local_quantities.at(name)});
+    }
+    return copies;
+}
+
+template <typename... Modules>
+pipeline_detail::copy_list static_module_pipeline<Modules...>::make_output_copies(
+    state_map* output_quantities)
+{
+    pipeline_detail::copy_list copies;
+    for (std::string const& name : get_outputs()) {
+        copies.push_back({&local_quantities.at(name), get_op(output_quantities, name)});
+    }
+    return copies;
+}
+
+template <typename... Modules>
+void static_module_pipeline<Modules...>::do_operation() const
+{
+    for (auto const& c : input_copies) {
+        *c.second = *c.first;
+    }
+
+    run_members(std::integral_constant<size_t, sizeof...(Modules)>{});
+
+    for (auto const& c : output_copies) {
+        update(c.second, *c.first);
+    }
+}
+
+}  // namespace BioCroWP
+#endif
@@ -0,0 +1,303 @@
+#include <algorithm>  // for std::max
+#include <cmath>      // for std::abs
+#include "steady_state_pressure_potential.h"
+
+using BioCroWP::steady_state_pressure_potential;
+
+namespace
+{
+// Density of water, the same value used by pressure_potential
+double const pw = 998200;  // g / m3
+
+// Solver settings
+int const max_iterations = 100;
+double const relative_tolerance = 1e-12;
+
+/**
+ *  @brief The root, stem, and leaf flow balance.
+ *
+ *  For a given leaf pressure potential, the leaf and stem balances determine
+ *  the flows and therefore the stem and root pressure potentials; `shoot()`
+ *  calculates these along with their derivatives with respect to the leaf
+ *  pressure potential and returns the remaining imbalance of the root
+ *  (g / ha / hr). The root pressure potential increases with the leaf pressure
+ *  potential while the root imbalance never increases, so each equation can be
+ *  solved by a one-dimensional search.
+ */
+struct flow_balance {
+    double F_rwu;            // g / ha / hr
+    double transpiration;    // g / ha / hr
+    double R_root_stem;      // MPa * hr * ha / g
+    double R_stem_leaf;      // MPa * hr * ha / g
+    double wp_crit;          // MPa
+    double root_osmotic;     // MPa
+    double stem_osmotic;     // MPa
+    double leaf_osmotic;     // MPa
+    double root_growth;      // g / ha / hr / MPa
+    double stem_growth;      // g / ha / hr / MPa
+    double leaf_growth;      // g / ha / hr / MPa
+
+    double shoot(
+        double P_leaf,
+        double& P_stem,
+        double& P_root,
+        double& dP_root,
+        double& d_imbalance) const
+    {
+        bool const leaf_growing = P_leaf > wp_crit;
+        double const F_stem_leaf =
+            transpiration + leaf_growth * std::max(P_leaf - wp_crit, 0.0);
+        double const dF_stem_leaf = leaf_growing ? leaf_growth : 0;
+
+        P_stem = P_leaf + leaf_osmotic + R_stem_leaf * F_stem_leaf - stem_osmotic;
+        double const dP_stem = 1 + R_stem_leaf * dF_stem_leaf;
+
+        bool const stem_growing = P_stem > wp_crit;
+        double const F_root_stem =
+            F_stem_leaf + stem_growth * std::max(P_stem - wp_crit, 0.0);
+        double const dF_root_stem = dF_stem_leaf + (stem_growing ? stem_growth * dP_stem : 0);
+
+        P_root = P_stem + stem_osmotic + R_root_stem * F_root_stem - root_osmotic;
+        dP_root = dP_stem + R_root_stem * dF_root_stem;
+
+        // As in pressure_potential, the root does not lose water when the stem
+        // draws more than the root takes up from the soil
+        bool const root_filling = F_rwu - F_root_stem > 0;
+        bool const root_growing = P_root > wp_crit;
+
+        d_imbalance = -(root_filling ? dF_root_stem : 0) -
+                      (root_growing ? root_growth * dP_root : 0);
+
+        return (root_filling ? F_rwu - F_root_stem : 0) -
+               root_growth * std::max(P_root - wp_crit, 0.0);
+    }
+};
+
+/**
+ *  @brief Finds a zero of a continuous, nondecreasing, piecewise-linear
+ *  function `h`, starting from `x`.
+ *
+ *  `h(x, dh)` must return the function value and set `dh` to its derivative.
+ *  A bracket is first found by taking Newton steps (or unit steps where the
+ *  function is flat) and doubling them until the sign changes. Newton steps are
+ *  then taken within the bracket, with bisection used whenever a Newton step
+ *  would leave it. Within each linear piece a Newton step is exact, so only a
+ *  few iterations are needed when `x` is a good estimate.
+ */
+template <typename function>
+double find_zero(function const& h, double x)
+{
+    double dh;
+    double hx = h(x, dh);
+    if (hx == 0) {
+        return x;
+    }
+
+    // Expand a step from `x` until the sign of `h` changes
+    double step = dh > 0 ? -hx / dh : (hx > 0 ? -1.0 : 1.0);
+    double y = x;
+    double dhy;
+    double hy = hx;
+    for (int i = 0; i < max_iterations; ++i, step *= 2) {
+        y = x + step;
+        hy = h(y, dhy);
+        if (hy == 0) {
+            return y;
+        }
+        if ((hy > 0) != (hx > 0)) {
+            break;
+        }
+        x = y;
+        hx = hy;
+        dh = dhy;
+    }
+
+    if ((hy > 0) == (hx > 0)) {
+        return y;  // No sign change was found
+    }
+
+    double lo = hx < 0 ? x : y;
+    double hi = hx < 0 ? y : x;
+
+    // Start from the end point whose value is closest to zero
+    if (std::abs(hy) < std::abs(hx)) {
+        x = y;
+        hx = hy;
+        dh = dhy;
+    }
+
+    for (int i = 0; i < max_iterations; ++i) {
+        double next = dh > 0 ? x - hx / dh : lo;
+        if (!(next > lo && next < hi)) {
+            next = 0.5 * (lo + hi);
+        }
+
+        bool const converged =
+            std::abs(next - x) <= relative_tolerance * (1 + std::abs(x));
+
+        x = next;
+        hx = h(x, dh);
+        if (hx == 0 || converged) {
+            return x;
+        }
+
+        (hx < 0 ? lo : hi) = x;
+
+        if (hi - lo <= relative_tolerance * (1 + std::abs(x))) {
+            return x;
+        }
+    }
+
+    return x;
+}
+}  // namespace
+
+steady_state_pressure_potential::steady_state_pressure_potential(
+    state_map const& input_quantities,
+    state_map* output_quantities)
+    : direct_module(),
+
+      // Get references to input quantities
+      canopy_transpiration_rate{get_input(input_quantities, "canopy_transpiration_rate")},
+      uptake_layer_1{get_input(input_quantities, "uptake_layer_1")},
+      uptake_layer_2{get_input(input_quantities, "uptake_layer_2")},
+      uptake_layer_3{get_input(input_quantities, "uptake_layer_3")},
+      uptake_layer_4{get_input(input_quantities, "uptake_layer_4")},
+      uptake_layer_5{get_input(input_quantities, "uptake_layer_5")},
+      uptake_layer_6{get_input(input_quantities, "uptake_layer_6")},
+
+      root_osmotic_potential{get_input(input_quantities, "root_osmotic_potential")},
+      stem_osmotic_potential{get_input(input_quantities, "stem_osmotic_potential")},
+      leaf_osmotic_potential{get_input(input_quantities, "leaf_osmotic_potential")},
+
+      root_volume{get_input(input_quantities, "root_volume")},
+      stem_volume{get_input(input_quantities, "stem_volume")},
+      leaf_volume{get_input(input_quantities, "leaf_volume")},
+
+      ext_root_x{get_input(input_quantities, "ext_root_x")},
+      ext_root_z{get_input(input_quantities, "ext_root_z")},
+
+      ext_stem_x{get_input(input_quantities, "ext_stem_x")},
+      ext_stem_z{get_input(input_quantities, "ext_stem_z")},
+
+      ext_leaf_x{get_input(input_quantities, "ext_leaf_x")},
+      ext_leaf_y{get_input(input_quantities, "ext_leaf_y")},
+      ext_leaf_z{get_input(input_quantities, "ext_leaf_z")},
+
+      wp_crit{get_input(input_quantities, "wp_crit")},
+
+      R_root_stem{get_input(input_quantities, "R_root_stem")},
+      R_stem_leaf{get_input(input_quantities, "R_stem_leaf")},
+
+      // Get pointers to output quantities
+      root_pressure_potential_op{get_op(output_quantities, "root_pressure_potential")},
+      stem_pressure_potential_op{get_op(output_quantities, "stem_pressure_potential")},
+      leaf_pressure_potential_op{get_op(output_quantities, "leaf_pressure_potential")}
+{
+}
+
+string_vector steady_state_pressure_potential::get_inputs()
+{
+    return {
+        "canopy_transpiration_rate",  // Mg/(ha*hr)
+        "uptake_layer_1",             // Mg/(ha*hr)
+        "uptake_layer_2",
+        "uptake_layer_3",
+        "uptake_layer_4",
+        "uptake_layer_5",
+        "uptake_layer_6",
+
+        "root_osmotic_potential",     // MPa
+        "stem_osmotic_potential",
+        "leaf_osmotic_potential",
+
+        "root_volume",                // m3
+        "stem_volume",
+        "leaf_volume",
+
+        "ext_root_x",                 // MPa-1 hr-1
+        "ext_root_z",
+
+        "ext_stem_x",
+        "ext_stem_z",
+
+        "ext_leaf_x",
+        "ext_leaf_y",
+        "ext_leaf_z",
+
+        "wp_crit",                    // MPa
+
+        "R_root_stem",                // MPa h g-1 ha
+        "R_stem_leaf"
+    };
+}
+
+string_vector steady_state_pressure_potential::get_outputs()
+{
+    return {
+        "root_pressure_potential",  // MPa
+        "stem_pressure_potential",  // MPa
+        "leaf_pressure_potential"   // MPa
+    };
+}
+
+void steady_state_pressure_potential::do_operation() const
+{
+    flow_balance const fb{
+        // Negative sign because RWU is negative in the soil water model
+        -(uptake_layer_1 + uptake_layer_2 + uptake_layer_3 +
+          uptake_layer_4 + uptake_layer_5 + uptake_layer_6) * 1000000,  // g ha-1 hr-1
+        canopy_transpiration_rate * 1000000,                            // g ha-1 hr-1
+        R_root_stem,
+        R_stem_leaf,
+        wp_crit,
+        root_osmotic_potential,
+        stem_osmotic_potential,
+        leaf_osmotic_potential,
+        pw * root_volume * (ext_root_z + 2 * ext_root_x),
+        pw * stem_volume * (ext_stem_z + 2 * ext_stem_x),
+        pw * leaf_volume * (ext_leaf_z + ext_leaf_x + ext_leaf_y)};
+
+    double P_stem;
+    double P_root;
+    double dP_root;
+    double d_imbalance;
+
+    // When the root neither fills nor grows, the root equation holds for any
+    // root pressure potential at or below `wp_crit`, so the search for the
+    // balance could stop anywhere in that range. First try the edge of the
+    // range, `wp_crit`; this is the solution whenever the root is not filling
+    // there. Otherwise the root is filling or growing, and the balance is
+    // unique. The previous solution is only used as a starting point, so the
+    // outputs do not depend on earlier calls.
+    double P_leaf = find_zero(
+        [&](double x, double& dh) {
+            fb.shoot(x, P_stem, P_root, dP_root, d_imbalance);
+            dh = dP_root;
+            return P_root - wp_crit;
+        },
+        has_previous_solution ? previous_leaf_pressure_potential : wp_crit);
+
+    if (fb.shoot(P_leaf, P_stem, P_root, dP_root, d_imbalance) != 0) {
+        P_leaf = find_zero(
+            [&](double x, double& dh) {
+                double const imbalance = fb.shoot(x, P_stem, P_root, dP_root, d_imbalance);
+                dh = -d_imbalance;
+                return -imbalance;
+            },
+            P_leaf);
+
+        fb.shoot(P_leaf, P_stem, P_root, dP_root, d_imbalance);
+
+        previous_leaf_pressure_potential = P_leaf;
+        has_previous_solution = true;
+    } else {
+        // Start the next search from the same point as a new module would
+        has_previous_solution = false;
+    }
+
+    // Update the output quantity list
+    update(root_pressure_potential_op, P_root);
+    update(stem_pressure_potential_op, P_stem);
+    update(leaf_pressure_potential_op, P_leaf);
+}
@@ -0,0 +1,110 @@
+#ifndef BioCroWP_STEADY_STATE_PRESSURE_POTENTIAL_H
+#define BioCroWP_STEADY_STATE_PRESSURE_POTENTIAL_H
+
+#include "../framework/module.h"
+#include "../framework/state_map.h"
+
+namespace BioCroWP
+{
+/**
+ * @class steady_state_pressure_potential
+ *
+ * @brief Calculates the root, stem, and leaf pressure potentials at hydraulic
+ * equilibrium with the current transpiration and root water uptake rates.
+ *
+ * This is a direct alternative to the `pressure_potential` differential module.
+ * The pressure potentials are the values at which every derivative calculated
+ * by `pressure_potential` would be zero for the current organ volumes; i.e.,
+ * the water flowing into each organ exactly supplies its plastic growth:
+ *
+ *  root: max(F_rwu - F_root_stem, 0) = pw * V_root * e_root * max(P_root - wp_crit, 0)
+ *
+ *  stem: F_root_stem - F_stem_leaf   = pw * V_stem * e_stem * max(P_stem - wp_crit, 0)
+ *
+ *  leaf: F_stem_leaf - transpiration = pw * V_leaf * e_leaf * max(P_leaf - wp_crit, 0)
+ *
+ * where the flows are driven by the total potential differences across
+ * `R_root_stem` and `R_stem_leaf` and the `e` terms are the summed organ
+ * extensibilities. The elastic moduli only set how quickly `pressure_potential`
+ * approaches this state, so they are not needed here.
+ *
+ * These equations are piecewise linear in the pressure potentials. For a
+ * given leaf pressure potential, the leaf and stem equations determine the
+ * flows and therefore the stem and root pressure potentials, and the remaining
+ * root imbalance never increases with the leaf pressure potential. The leaf
+ * pressure potential is therefore found with a one-dimensional Newton search
+ * that falls back to bisection whenever a step would leave the current bracket.
+ * When no water flows into the root, the root equation is satisfied by any
+ * root pressure potential at or below `wp_crit`. In that case the root
+ * pressure potential is set to the edge of that range, `wp_crit`, so the
+ * outputs do not depend on the rates used in earlier calls. Otherwise, each
+ * search is started from the solution of the previous call, which usually lies
+ * in the same linear piece, so only a few evaluations are needed; after a call
+ * without flow into the root, the next search starts from `wp_crit`, as it does
+ * for a new module.
+ *
+ * Using this module removes the pressure potentials from the differential
+ * quantities, along with the stiffness caused by the small organ capacitances.
+ * The organ water contents and volumes are not updated, so they must be
+ * supplied as parameters or by other modules. The total potentials can still
+ * be calculated by `total_potential` from the outputs of this module.
+ */
+class steady_state_pressure_potential : public direct_module
+{
+   public:
+    steady_state_pressure_potential(
+        state_map const& input_quantities,
+        state_map* output_quantities);
+
+    static string_vector get_inputs();
+    static string_vector get_outputs();
+    static std::string get_name() { return "steady_state_pressure_potential"; }
+
+   private:
+    // References to input quantities
+    double const& canopy_transpiration_rate;
+    double const& uptake_layer_1;
+    double const& uptake_layer_2;
+    double const& uptake_layer_3;
+    double const& uptake_layer_4;
+    double const& uptake_layer_5;
+    double const& uptake_layer_6;
+
+    double const& root_osmotic_potential;
+    double const& stem_osmotic_potential;
+    double const& leaf_osmotic_potential;
+
+    double const& root_volume;
+    double const& stem_volume;
+    double const& leaf_volume;
+
+    double const& ext_root_x;
+    double const& ext_root_z;
+
+    double const& ext_stem_x;
+    double const& ext_stem_z;
+
+    double const& ext_leaf_x;
+    double const& ext_leaf_y;
+    double const& ext_leaf_z;
+
+    double const& wp_crit;
+
+    double const& R_root_stem;
+    double const& R_stem_leaf;
+
+    // Pointers to output quantities
+    double* root_pressure_potential_op;
+    double* stem_pressure_potential_op;
+    double* leaf_pressure_potential_op;
+
+    // The solution from the previous call, used as the next starting point
+    mutable bool has_previous_solution = false;
+    mutable double previous_leaf_pressure_potential;
+
+    // Main operation
+    void do_operation() const;
+};
+
+}  // namespace BioCroWP
+#endif
@@ -53,6 +53,10 @@ class total_potential : public direct_module
     // main operation
     void do_operation() const;
 
+    // Lets a static_module_pipeline call do_operation() without virtual dispatch
+    template <typename... Modules>
+    friend class static_module_pipeline;
+
 };
 
 string_vector total_potential::get_inputs()
@@ -0,0 +1,67 @@
+#ifndef BioCroWP_TRIDIAGONAL_SYSTEM_H
+#define BioCroWP_TRIDIAGONAL_SYSTEM_H
+
+#include <vector>
+
+namespace BioCroWP
+{
+/**
+ *  @brief A tridiagonal linear system solved by the Thomas algorithm.
+ *
+ *  Row `i` of the matrix is `lower[i] * x[i - 1] + diagonal[i] * x[i] +
+ *  upper[i] * x[i + 1]`; `lower[0]` and `upper[n - 1]` are ignored. After the
+ *  coefficients are set, `factorize()` performs the forward elimination of the
+ *  matrix, and `solve()` can then be called for any number of right-hand sides.
+ *  Both take a time proportional to `n`, and no memory is allocated after
+ *  construction.
+ *
+ *  No pivoting is done, so the matrix should be diagonally dominant, as it is
+ *  for the implicit discretizations of diffusion equations used here.
+ */
+class tridiagonal_system
+{
+   public:
+    explicit tridiagonal_system(int n)
+        : lower(n),
+          diagonal(n),
+          upper(n),
+          n{n},
+          c_prime(n),
+          inverse_pivot(n)
+    {
+    }
+
+    std::vector<double> lower;
+    std::vector<double> diagonal;
+    std::vector<double> upper;
+
+    void factorize()
+    {
+        inverse_pivot[0] = 1.0 / diagonal[0];
+        c_prime[0] = upper[0] * inverse_pivot[0];
+        for (int i = 1; i < n; ++i) {
+            inverse_pivot[i] = 1.0 / (diagonal[i] - lower[i] * c_prime[i - 1]);
+            c_prime[i] = upper[i] * inverse_pivot[i];
+        }
+    }
+
+    // Replaces the right-hand side `x` by the solution
+    void solve(std::vector<double>& x) const
+    {
+        x[0] *= inverse_pivot[0];
+        for (int i = 1; i < n; ++i) {
+            x[i] = (x[i] - lower[i] * x[i - 1]) * inverse_pivot[i];
+        }
+        for (int i = n - 2; i >= 0; --i) {
+            x[i] -= c_prime[i] * x[i + 1];
+        }
+    }
+
+   private:
+    int n;
+    std::vector<double> c_prime;
+    std::vector<double> inverse_pivot;
+};
+
+}  // namespace BioCroWP
+#endif
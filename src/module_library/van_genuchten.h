@@ -0,0 +1,81 @@
+#ifndef BioCroWP_VAN_GENUCHTEN_H
+#define BioCroWP_VAN_GENUCHTEN_H
+
+#include <algorithm>  // for std::min, std::max
+#include <cmath>      // for pow, sqrt
+
+namespace BioCroWP
+{
+/**
+ *  @brief Soil water retention and conductivity relations of van Genuchten
+ *  (1980), shared by the modules that describe layered soils.
+ *
+ *  Pressure heads `h` are in cm of water and are negative in unsaturated soil;
+ *  `alpha` is in cm-1 and `n` and `m` are dimensionless. The same formula for
+ *  the head is used by `soil_potential`.
+ */
+namespace van_genuchten
+{
+// Effective saturations are kept above this value so that the head is finite
+double const min_effective_saturation = 1e-9;
+
+inline double effective_saturation(
+    double water_content,
+    double residual_wc,
+    double saturated_wc)
+{
+    double const Se = (water_content - residual_wc) / (saturated_wc - residual_wc);
+    return std::min(std::max(Se, min_effective_saturation), 1.0);
+}
+
+inline double head(double Se, double alpha, double n, double m)
+{
+    return -(1.0 / alpha) * pow(pow(1.0 / Se, 1.0 / m) - 1.0, 1.0 / n);  // cm
+}
+
+/**
+ *  @brief Calculates the effective saturation, the specific moisture capacity
+ *  `dSe / dh` (cm-1), and the Mualem (1976) relative conductivity and its
+ *  derivative with respect to `h` (cm-1) at the head `h`.
+ *
+ *  The relative conductivity assumes that m = 1 - 1 / n. When n is below 2,
+ *  its derivative grows without bound as `h` approaches zero. The four
+ *  quantities share most of their terms, so they are calculated together.
+ */
+inline void hydraulic_properties(
+    double h,
+    double alpha,
+    double n,
+    double m,
+    double& Se,
+    double& capacity,
+    double& relative_conductivity,
+    double& relative_conductivity_derivative)
+{
+    if (h >= 0) {
+        Se = 1.0;
+        capacity = 0.0;
+        relative_conductivity = 1.0;
+        relative_conductivity_derivative = 0.0;
+        return;
+    }
+
+    double const x = -alpha * h;
+    double const xn = pow(x, n);
+    double const p = pow(1.0 + xn, -m - 1.0);
+
+    Se = p * (1.0 + xn);
+    capacity = alpha * m * n * xn / x * p;
+
+    // Here Se^(1 / m) = 1 / (1 + xn)
+    double const um = pow(xn / (1.0 + xn), m);
+    double const s = 1.0 - um;
+    relative_conductivity = sqrt(Se) * s * s;
+
+    double const ds = alpha * m * n * um / (x * (1.0 + xn));  // ds / dh
+    relative_conductivity_derivative = sqrt(Se) * s * (0.5 * s * capacity / Se + 2.0 * ds);
+}
+
+}  // namespace van_genuchten
+}  // namespace BioCroWP
+#endif